@@ -1,4 +1,7 @@
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <limits.h>
 #include <alibc/containers/dynabuf.h>
 /**
@@ -12,7 +15,8 @@
  * Non-Guarantees:
  *  - Ordering.  The array is not ordered, insertion and removal will change
  *    the order of stored objects not inserted or removed unless the operation
- *    decays to fetch/append.
+ *    decays to fetch/append.  The *_ordered, erase_range and remove_if
+ *    operations preserve order, at the cost of linear time.
  */
 
 /*
@@ -20,10 +24,18 @@
  */
 typedef struct  {
     dynabuf_t   *data;
-    int    size;
+    size_t size;
     int    status;
 } array_t;
 
+/*
+ * Predicate function type, used to select elements of an array.
+ * @param item pointer to the element, as returned by array_fetch
+ * @param arg the argument given alongside the predicate
+ * @return true if the element is selected
+ */
+typedef bool (array_pred_type)(void **item, void *arg);
+
 /**
  * Error codes for array operations
  */
@@ -41,7 +53,39 @@ typedef enum {
  * @param unit the size of each array element
  * @return new array, or null on errors.
  */
-array_t *create_array(int size, int unit);
+array_t *create_array(size_t size, size_t unit);
+
+/*
+ * Constructor function for an array whose backing buffer reserves address
+ * space for max elements up front.  The array never moves as it grows, so
+ * pointers returned by array_fetch stay valid until the element is removed.
+ * Appending beyond max elements fails with ALC_ARRAY_NO_MEM.
+ * @param size the size to reserve.
+ * @param unit the size of each array element
+ * @param max the maximum number of elements the array can hold
+ * @return new array, or null on errors.
+ */
+array_t *create_array_reserved(size_t size, size_t unit, size_t max);
+
+/*
+ * Constructor function for an array stored in a memory-mapped file.  If the
+ * file holds an array written by a previous process, its contents are used as
+ * they are, without reloading.  Otherwise the file is created.  The element
+ * count is written back to the file by array_flush and array_free.
+ * @param path the file which stores the array
+ * @param size the size to reserve.
+ * @param unit the size of each array element, must match the stored array.
+ * @return new array, or null on errors.
+ */
+array_t *create_array_mmap(const char *path, size_t size, size_t unit);
+
+/*
+ * Write the contents of a file-backed array to its file.  This is a no-op for
+ * arrays which are not file-backed.
+ * @param self the array to flush
+ * @return ALC_ARRAY_* error code
+ */
+int array_flush(array_t *self);
 
 /*
  * Insert a new value into the array
@@ -50,7 +94,17 @@ array_t *create_array(int size, int unit);
  * @param item the object to store
  * @return ALC_ARRAY_* error code
  */
-int array_insert(array_t *self, int where, void* item);
+int array_insert(array_t *self, size_t where, void* item);
+
+/*
+ * Insert a new value into the array, shifting every later object up by one
+ * position so that the order of stored objects is preserved.
+ * @param self array to insert into
+ * @param where the location at which to insert
+ * @param item the object to store
+ * @return ALC_ARRAY_* error code
+ */
+int array_insert_ordered(array_t *self, size_t where, void *item);
 
 /*
  * Append a new value to the end of the array
@@ -60,6 +114,39 @@ int array_insert(array_t *self, int where, void* item);
  */
 int array_append(array_t *self, void* item);
 
+/*
+ * Append a block of values to the end of the array.  Space is reserved once
+ * and the block is copied with a single memcpy.
+ * @param self the array to append to
+ * @param src pointer to count contiguous elements, each of the array's unit
+ * size.  src must not point into self.
+ * @param count the number of elements to append
+ * @return ALC_ARRAY_* error code
+ */
+int array_append_n(array_t *self, void *src, size_t count);
+
+/*
+ * Append every element of another array to the end of this array.
+ * @param self the array to append to
+ * @param other the array whose elements are copied, may be self.  Both arrays
+ * must have the same unit size.
+ * @return ALC_ARRAY_* error code
+ */
+int array_extend(array_t *self, array_t *other);
+
+/*
+ * Insert a block of values into the array.  Like array_insert, the displaced
+ * objects are moved to the end of the array, so the order of stored objects
+ * is not preserved.
+ * @param self the array to insert into
+ * @param where the location at which to insert the first value
+ * @param src pointer to count contiguous elements, each of the array's unit
+ * size.  src must not point into self.
+ * @param count the number of elements to insert
+ * @return ALC_ARRAY_* error code
+ */
+int array_insert_range(array_t *self, size_t where, void *src, size_t count);
+
 /*
  * Insert a new value into the array without swapping, thus overwriting
  * any previously stored value at that index.
@@ -68,7 +155,7 @@ int array_append(array_t *self, void* item);
  * @param item the value to store at the specified index.
  * @return ALC_ARRAY_* error code
  */
-int array_insert_unsafe(array_t *self, int where, void *item);
+int array_insert_unsafe(array_t *self, size_t where, void *item);
 
 /*
  * Retrieve an item from the array
@@ -76,7 +163,47 @@ int array_insert_unsafe(array_t *self, int where, void *item);
  * @param which the index to fetch
  * @return pointer to the item, or NULL if it does not exist.
  */
-void **array_fetch(array_t *self, int which);
+void **array_fetch(array_t *self, size_t which);
+
+/*
+ * Retrieve the backing buffer of the array, for direct access to the
+ * contiguous elements.  The pointer is invalidated by any operation which
+ * resizes the array.  No validity checks are performed.
+ * @param self the array to use, must be valid.
+ * @return pointer to the first element.
+ */
+static inline void *array_data(array_t *self) {
+    return self->data->buf;
+}
+
+/*
+ * Retrieve an item from the array without validity or bounds checks, and
+ * without updating the array status.
+ * @param self the array to use, must be valid.
+ * @param which the index to fetch, must be less than array_size(self).
+ * @return pointer to the item.
+ */
+static inline void **array_at_unchecked(array_t *self, size_t which) {
+    return dynabuf_at(self->data, which);
+}
+
+/*
+ * Loop over every element of a valid array, in index order, without going
+ * through the iterator interface.  item must be a void ** declared by the
+ * caller, and is set to each element as array_fetch would return it.  The
+ * array must not be modified within the loop; break and continue behave as in
+ * any other loop.
+ * Example:
+ * void **item;
+ * ALC_ARRAY_FOREACH(array, item) {
+ *     total += (int64_t)*item;
+ * }
+ */
+#define ALC_ARRAY_FOREACH(self, item)                                       \
+    for(size_t _alc_i = 0;                                                  \
+        _alc_i < (self)->size                                               \
+            && ((item) = array_at_unchecked((self), _alc_i), 1);            \
+        _alc_i++)
 
 /*
  * Allocate space for at least count items.
@@ -86,7 +213,7 @@ void **array_fetch(array_t *self, int which);
  * @param count the number of items which should be able to fit in the array.
  * @return ALC_ARRAY_* error code
  */
-int array_resize(array_t *self, int count);
+int array_resize(array_t *self, size_t count);
 
 /*
  * Remove an item from the array
@@ -94,16 +221,46 @@ int array_resize(array_t *self, int count);
  * @param which the index to remove
  * @return the item, or NULL if it does not exist.
  */
-void **array_remove(array_t *self, int which);
+void **array_remove(array_t *self, size_t which);
+
+/*
+ * Remove a range of items from the array, shifting every later object down so
+ * that the order of stored objects is preserved.
+ * @param self the array from which to remove the items
+ * @param begin the index of the first item to remove
+ * @param count the number of items to remove
+ * @return ALC_ARRAY_* error code
+ */
+int array_erase_range(array_t *self, size_t begin, size_t count);
 
 /*
- * Cause the index of two objects in the array to be exchanged
+ * Remove every item for which pred returns true, in a single pass.  The order
+ * of the remaining objects is preserved.  pred is called exactly once per
+ * item, in index order.
+ * @param self the array to filter
+ * @param pred predicate selecting the items to remove
+ * @param arg argument passed to every call of pred
+ * @return the number of items removed, or a negative ALC_ARRAY_* error code
+ */
+int64_t array_remove_if(array_t *self, array_pred_type *pred, void *arg);
+
+/*
+ * Cause the index of two objects in the array to be exchanged.  Elements are
+ * exchanged through a stack buffer, so the swap never allocates.
  * @param self the array to adjust
  * @param first the index of the first object to swap
  * @param second the index of the second object to swap
  * @return ALC_ARRAY_* error code
  */
-int array_swap(array_t *self, int first, int second);
+int array_swap(array_t *self, size_t first, size_t second);
+
+/*
+ * Select how the array grows when it runs out of space.
+ * @param self the array to configure
+ * @param policy dynabuf_growth_t growth policy
+ * @return ALC_ARRAY_* error code
+ */
+int array_set_growth(array_t *self, int policy);
 
 /*
  * Compute the size of the array, in entries.  The size in bytes is
@@ -111,7 +268,7 @@ int array_swap(array_t *self, int first, int second);
  * @param self the array to compute the size of
  * @return the size, -1 on error.
  */
-int array_size(array_t *self);
+int64_t array_size(array_t *self);
 
 /*
  * Return the memory used to allocate the array and underlying buffers to the
@@ -8,3 +8,24 @@
  * @return a new iterator context, or NULL on error.
  */
 iter_context *create_array_iterator(array_t *target);
+
+/**
+ * Create a new iterator over the elements [begin, end) of the given array.
+ * end may be ALC_ITER_END, and is clamped to the size of the array.
+ * @param target The array whose elements will be iterated over
+ * @param begin the index of the first element to visit
+ * @param end one past the index of the last element to visit
+ * @return a new iterator context, or NULL on error.
+ */
+iter_context *create_array_iterator_range(array_t *target, size_t begin,
+        size_t end);
+
+/**
+ * Initialize an iterator over the given array in caller-provided storage,
+ * starting at the first element.  No memory is allocated.
+ * @param ctx the context to fill in
+ * @param target The array whose elements will be iterated over
+ * @return ALC_ITER_READY, ALC_ITER_NULL if ctx is NULL, or ALC_ITER_INVALID if
+ * target is NULL.
+ */
+int iter_init_array(iter_context *ctx, array_t *target);
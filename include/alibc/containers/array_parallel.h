@@ -0,0 +1,87 @@
+#pragma once
+#include <stddef.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/comparable.h>
+#include <alibc/containers/thread_pool.h>
+
+/**
+ * alibc/containers parallel array algorithms
+ * Loops, reductions and sorting over array_t, split into index ranges which
+ * run on a thread_pool_t.  The array must not be modified by other threads
+ * while these run.
+ */
+
+// ranges are not split below this many elements
+#ifndef ALC_ARRAY_PARALLEL_GRAIN
+#define ALC_ARRAY_PARALLEL_GRAIN 4096
+#endif
+
+/*
+ * Range function type, called once for each range of a parallel loop.
+ * @param self the array being processed
+ * @param begin the first index of the range
+ * @param end one past the last index of the range
+ * @param arg the argument given alongside the function
+ */
+typedef void (array_range_fn)(array_t *self, size_t begin, size_t end,
+        void *arg);
+
+/*
+ * Reduce function type, folds a range of the array into partial.
+ * @param self the array being processed
+ * @param begin the first index of the range
+ * @param end one past the last index of the range
+ * @param partial the partial result for this range, initialized from the
+ * identity passed to array_parallel_reduce.
+ * @param arg the argument given alongside the function
+ */
+typedef void (array_reduce_fn)(array_t *self, size_t begin, size_t end,
+        void *partial, void *arg);
+
+/*
+ * Combine function type, folds partial into result.  Partial results are
+ * combined in index order, so the operation must be associative but need not
+ * be commutative.
+ * @param result the running result
+ * @param partial the partial result of the next range
+ * @param arg the argument given alongside the function
+ */
+typedef void (array_combine_fn)(void *result, void *partial, void *arg);
+
+/**
+ * Call fn over disjoint ranges covering the whole array, in parallel.
+ * @param self the array to process
+ * @param pool the thread pool to run on
+ * @param fn the range function
+ * @param arg argument passed to fn
+ * @return array_error_t error code
+ */
+int array_parallel_for(array_t *self, thread_pool_t *pool, array_range_fn *fn,
+        void *arg);
+
+/**
+ * Reduce the array to a single result, in parallel.
+ * @param self the array to process
+ * @param pool the thread pool to run on
+ * @param fn the reduce function
+ * @param combine the combine function
+ * @param result holds the identity of the reduction on entry, and the result
+ * on return.
+ * @param result_size the size of the result, in bytes.
+ * @param arg argument passed to fn and combine
+ * @return array_error_t error code
+ */
+int array_parallel_reduce(array_t *self, thread_pool_t *pool,
+        array_reduce_fn *fn, array_combine_fn *combine, void *result,
+        size_t result_size, void *arg);
+
+/**
+ * Sort the array, in parallel.  Ranges are sorted with array_sort, then
+ * merged pairwise with each merge split across the pool.  Unlike array_sort
+ * this needs a scratch buffer the size of the array.
+ * @param self the array to sort
+ * @param pool the thread pool to run on
+ * @param cmp the comparator, as for array_sort.
+ * @return array_error_t error code
+ */
+int array_parallel_sort(array_t *self, thread_pool_t *pool, cmp_type *cmp);
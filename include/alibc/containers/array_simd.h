@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <alibc/containers/array.h>
+
+/**
+ * alibc/containers vectorized array kernels
+ * Scans over arrays of 1, 2, 4 or 8 byte integers, which work directly on the
+ * array's buffer.  Each kernel is compiled for AVX2, SSE4.1 and the baseline
+ * instruction set, and the best version supported by the running CPU is
+ * chosen at runtime.  Only x86 has vectorized versions; other platforms use
+ * the baseline build.
+ */
+
+/**
+ * Find the first element equal to value in an array of 4 byte integers.
+ * @param self the array to search, with elements of 4 bytes.
+ * @param value the value to search for
+ * @return the index of the element, the size of the array if there is none,
+ * or a negative array_error_t code on error.
+ */
+int64_t array_find_i32(array_t *self, int32_t value);
+
+/**
+ * Find the first element equal to value in an array of 8 byte integers.
+ * @param self the array to search, with elements of 8 bytes.
+ * @param value the value to search for
+ * @return the index of the element, the size of the array if there is none,
+ * or a negative array_error_t code on error.
+ */
+int64_t array_find_i64(array_t *self, int64_t value);
+
+/**
+ * Count the elements equal to value in an array of integers.
+ * @param self the array to search, with elements of 1, 2, 4 or 8 bytes.
+ * @param value the value to count, truncated to the element size.
+ * @return the number of equal elements, or a negative array_error_t code on
+ * error.
+ */
+int64_t array_count_eq(array_t *self, int64_t value);
+
+/**
+ * Find the smallest element of a non-empty array of integers.
+ * @param self the array to search, with elements of 1, 2, 4 or 8 bytes.
+ * @param is_signed true if the elements are two's complement signed integers.
+ * @param out receives the smallest element, sign or zero extended.  Unsigned
+ * 8 byte results should be read back as uint64_t.
+ * @return array_error_t error code, ALC_ARRAY_IDX_OOB if the array is empty.
+ */
+int array_min(array_t *self, bool is_signed, int64_t *out);
+
+/**
+ * Find the largest element of a non-empty array of integers.
+ * @param self the array to search, with elements of 1, 2, 4 or 8 bytes.
+ * @param is_signed true if the elements are two's complement signed integers.
+ * @param out receives the largest element, as for array_min.
+ * @return array_error_t error code, ALC_ARRAY_IDX_OOB if the array is empty.
+ */
+int array_max(array_t *self, bool is_signed, int64_t *out);
+
+/**
+ * Sum the elements of an array of integers, wrapping modulo 2^64.
+ * @param self the array to sum, with elements of 1, 2, 4 or 8 bytes.
+ * @param is_signed true if the elements are two's complement signed integers.
+ * @param out receives the sum.
+ * @return array_error_t error code
+ */
+int array_sum(array_t *self, bool is_signed, int64_t *out);
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdbool.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/comparable.h>
+
+/**
+ * alibc/containers array sorting
+ * In-place sorts for array_t, and searches over sorted arrays.  Elements are
+ * compared and swapped directly in the array's buffer, with code specialized
+ * for elements of 1, 2, 4 and 8 bytes.
+ */
+
+/**
+ * Sort an array in ascending order of the given comparator.  The sort is an
+ * introsort: quicksort with a median-of-three pivot, switching to insertion
+ * sort for short ranges and to heapsort when the recursion gets too deep, so
+ * the worst case is O(n log n).  The sort is not stable.
+ * @param self the array to sort
+ * @param cmp the comparator.  Following the dynabuf convention, elements of
+ * up to sizeof(void*) bytes are passed by value, and larger elements are
+ * passed as pointers into the array.
+ * @return array_error_t error code
+ */
+int array_sort(array_t *self, cmp_type *cmp);
+
+/**
+ * Sort part of an array, as with array_sort.  Elements outside the range are
+ * not touched.
+ * @param self the array to sort
+ * @param begin the index of the first element to sort
+ * @param count the number of elements to sort
+ * @param cmp the comparator, as for array_sort.
+ * @return array_error_t error code
+ */
+int array_sort_range(array_t *self, size_t begin, size_t count,
+        cmp_type *cmp);
+
+/**
+ * Sort an array of integers in ascending order with an LSD radix sort.  The
+ * sort is stable, and allocates a scratch buffer the size of the array.
+ * @param self the array to sort, whose elements must be 1, 2, 4 or 8 bytes.
+ * @param is_signed true if the elements are two's complement signed integers.
+ * @return array_error_t error code
+ */
+int array_radix_sort(array_t *self, bool is_signed);
+
+/**
+ * Find the first element of a sorted array which is not less than key.
+ * @param self the array to search, sorted in ascending order of cmp.
+ * @param key the key to search for, passed as an element would be.
+ * @param cmp the comparator the array is sorted by, as for array_sort.  The
+ * element is always passed as the first argument and the key as the second.
+ * @return the index of the element, the size of the array if every element
+ * is less than key, or a negative array_error_t code on error.
+ */
+int64_t array_lower_bound(array_t *self, void *key, cmp_type *cmp);
+
+/**
+ * Find the first element of a sorted array which is greater than key.
+ * @param self the array to search, sorted in ascending order of cmp.
+ * @param key the key to search for, passed as an element would be.
+ * @param cmp the comparator the array is sorted by, as for array_lower_bound.
+ * @return the index of the element, the size of the array if no element is
+ * greater than key, or a negative array_error_t code on error.
+ */
+int64_t array_upper_bound(array_t *self, void *key, cmp_type *cmp);
+
+/**
+ * Find an element of a sorted array which is equal to key.
+ * @param self the array to search, sorted in ascending order of cmp.
+ * @param key the key to search for, passed as an element would be.
+ * @param cmp the comparator the array is sorted by, as for array_lower_bound.
+ * @return pointer to the first equal element, as returned by array_fetch, or
+ * NULL if there is none or on error.
+ */
+void **array_bsearch(array_t *self, void *key, cmp_type *cmp);
@@ -1,4 +1,7 @@
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include <alibc/containers/dynabuf.h>
 /*
  * Linear Bitmap
@@ -18,7 +21,7 @@ typedef dynabuf_t bitmap_t;
  * @param max the new max-value to store in the set.
  * @return the new bitmap, or NULL on errors.
  */
-bitmap_t *create_bitmap(int size);
+bitmap_t *create_bitmap(size_t size);
 
 /*
  * Resize the bitmap to hold a maximum value of a given size.
@@ -26,7 +29,7 @@ bitmap_t *create_bitmap(int size);
  * @param max the new max-value to store in the set.
  * @return pointer to the resized set, or NULL on error.
  */
-bitmap_t *bitmap_resize(bitmap_t *self, int max);
+bitmap_t *bitmap_resize(bitmap_t *self, size_t max);
 
 /*
  * Check for the existence of key in the given bitmap
@@ -34,21 +37,64 @@ bitmap_t *bitmap_resize(bitmap_t *self, int max);
  * @param key the key to find in the set
  * @return non-zero value for true, else zero.
  */
-int bitmap_contains(bitmap_t *self, int key);
+int bitmap_contains(bitmap_t *self, size_t key);
 
 /*
  * Insert a key into the given bitmap
  * @param self the bitmap to use
  * @param key the key which should be added
  */
-void bitmap_add(bitmap_t *self, int key);
+void bitmap_add(bitmap_t *self, size_t key);
 
 /*
  * Zero-out the entry at key in the given bitmap
  * @param self the bitmap to use
  * @param key the key which should be forgotten
  */
-void bitmap_remove(bitmap_t *self, int key);
+void bitmap_remove(bitmap_t *self, size_t key);
+
+/*
+ * Find the first key in the bitmap which is at least from.  With GCC or clang
+ * the bitmap is scanned a 64-bit word at a time, so runs of absent keys are
+ * cheap to skip; other compilers scan a byte at a time.
+ * @param self the bitmap to use
+ * @param from the first key to consider
+ * @param limit one past the last key to consider
+ * @return the next key present in the bitmap, or limit if there is none.
+ */
+static inline size_t bitmap_next(bitmap_t *self, size_t from, size_t limit) {
+    const unsigned char *bytes = (const unsigned char*)self->buf;
+    while(from < limit) {
+        size_t byte_index = from >> 3;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__)
+        if(byte_index + sizeof(uint64_t) <= self->capacity) {
+            uint64_t word;
+            memcpy(&word, bytes + byte_index, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            word = __builtin_bswap64(word);
+#endif
+            word >>= from & 7;
+            if(word != 0) {
+                from += __builtin_ctzll(word);
+                return (from < limit) ? from:limit;
+            }
+            from = (byte_index << 3) + 64;
+            continue;
+        }
+#endif
+        // the tail of the bitmap, or every byte without the builtins
+        unsigned byte = bytes[byte_index] >> (from & 7);
+        if(byte != 0) {
+            while(!(byte & 1)) {
+                byte >>= 1;
+                from++;
+            }
+            return (from < limit) ? from:limit;
+        }
+        from = (byte_index + 1) << 3;
+    }
+    return limit;
+}
 
 /*
  * Destroy the target bitmap
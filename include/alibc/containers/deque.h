@@ -0,0 +1,140 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <alibc/containers/dynabuf.h>
+
+/**
+ * alibc/containers deque interface
+ * A segmented array: elements live in fixed-size dynabuf blocks, and a block
+ * map records the blocks in order.  Growing the deque adds blocks and never
+ * moves existing elements.
+ * Guarantees:
+ *  - Constant push/pop time at both ends (amortized over block map growth)
+ *  - Constant fetch time
+ *  - Stable addresses: a pointer returned by deque_fetch stays valid until
+ *    that element is popped.
+ *  - Memory-safe - objects stored must be deallocated on their own.
+ * Non-Guarantees:
+ *  - contiguous allocation.  Only elements within the same block are
+ *    adjacent in memory.
+ */
+
+/*
+ * deque type definition
+ * map is a dynabuf of dynabuf_t pointers, of which nblocks are in use from
+ * map_first onwards.  Element i lives at position head + i counted from the
+ * start of the first block.  spare keeps the most recently emptied block, so
+ * that pushing and popping across a block boundary does not allocate.
+ */
+typedef struct {
+    dynabuf_t   *map;
+    dynabuf_t   *spare;
+    size_t      map_first;
+    size_t      nblocks;
+    size_t      head;
+    size_t      size;
+    size_t      block_elems;
+    size_t      block_shift;
+    size_t      elem_size;
+    int         status;
+} deque_t;
+
+/**
+ * Error codes for deque operations
+ */
+typedef enum {
+    ALC_DEQUE_SUCCESS = 0,
+    ALC_DEQUE_IDX_OOB = INT_MIN,
+    ALC_DEQUE_INVALID,
+    ALC_DEQUE_NO_MEM
+} deque_error_t;
+
+// default size of each block, in bytes
+#ifndef ALC_DEQUE_BLOCK_BYTES
+#define ALC_DEQUE_BLOCK_BYTES 4096
+#endif
+
+/*
+ * Constructor function for deque type
+ * @param block_elems the number of elements in each block, rounded up to a
+ * power of two.  0 picks blocks of about ALC_DEQUE_BLOCK_BYTES.
+ * @param unit the size of each element
+ * @return new deque, or null on errors.
+ */
+deque_t *create_deque(size_t block_elems, size_t unit);
+
+/*
+ * Add an item after the last element
+ * @param self the deque to push to
+ * @param item the item to push, as for array_append.
+ * @return deque_error_t error code
+ */
+int deque_push_back(deque_t *self, void *item);
+
+/*
+ * Add an item before the first element
+ * @param self the deque to push to
+ * @param item the item to push, as for array_append.
+ * @return deque_error_t error code
+ */
+int deque_push_front(deque_t *self, void *item);
+
+/*
+ * Remove the last element
+ * @param self the deque to pop from
+ * @return pointer to the removed item, valid until the next modification, or
+ * NULL on error.
+ */
+void **deque_pop_back(deque_t *self);
+
+/*
+ * Remove the first element
+ * @param self the deque to pop from
+ * @return pointer to the removed item, valid until the next modification, or
+ * NULL on error.
+ */
+void **deque_pop_front(deque_t *self);
+
+/*
+ * Fetch an item from the deque
+ * @param self the deque to fetch from
+ * @param which the index of the item, counted from the front.
+ * @return pointer to the item, or NULL on error
+ */
+void **deque_fetch(deque_t *self, size_t which);
+
+/*
+ * Compute the size of the deque
+ * @param self the deque to use
+ * @return the number of elements in the deque, -1 on error.
+ */
+int64_t deque_size(deque_t *self);
+
+/*
+ * Free the deque and all of its blocks.
+ * @param self the deque to free
+ */
+void deque_free(deque_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the deque to validate
+ * @return deque_error_t error code of the most recent operation
+ */
+int deque_status(deque_t *self);
+
+/*
+ * Fetch an item without any checks, for hot loops which have already
+ * validated the deque and the index.
+ * @param self the deque to fetch from, must be valid.
+ * @param which the index of the item, must be less than the deque size.
+ * @return pointer to the item, as with deque_fetch.
+ */
+static inline void **deque_at_unchecked(deque_t *self, size_t which) {
+    size_t pos = self->head + which;
+    dynabuf_t *block = *(dynabuf_t**)dynabuf_at(
+        self->map, self->map_first + (pos >> self->block_shift)
+    );
+    return dynabuf_at(block, pos & (self->block_elems - 1));
+}
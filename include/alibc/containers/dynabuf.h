@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <limits.h>
 
 /**
@@ -12,10 +13,44 @@
  * A double-pointer is always returned, regardless of the element size.
  */
 
+/*
+ * Backing store of a dynabuf.
+ *  - HEAP buffers are allocated with malloc and grown with realloc.
+ *  - RESERVED buffers reserve a fixed range of address space up front and
+ *    commit pages to it as they grow, so growth never copies and the buffer
+ *    never moves.  Only available on platforms with mmap.
+ *  - MAPPED buffers map a file as their backing store, so their contents
+ *    persist after the dynabuf is freed.  Only available on platforms with
+ *    mmap.
+ *  - BORROWED buffers are owned by the caller, for example storage embedded
+ *    in another structure.  The first resize moves the contents to a new HEAP
+ *    buffer, and the borrowed buffer is never freed by the dynabuf.
+ */
+typedef enum {
+    ALC_DYNABUF_HEAP = 0,
+    ALC_DYNABUF_RESERVED,
+    ALC_DYNABUF_MAPPED,
+    ALC_DYNABUF_BORROWED
+} dynabuf_mode_t;
+
+/*
+ * capacity is the usable size in bytes.  reserved is the size in bytes of the
+ * address space range held by RESERVED buffers, and is unused otherwise.
+ * MAPPED buffers keep the file descriptor of their backing file in fd, and
+ * header is the number of bytes of that file which precede buf.  align is the
+ * alignment in bytes of HEAP buffers created by create_dynabuf_aligned, which
+ * is kept across resizes, or 0 for plain malloc alignment.
+ */
 typedef struct {
     char *buf;
-    int capacity;
-    int elem_size;
+    size_t capacity;
+    size_t elem_size;
+    size_t reserved;
+    size_t header;
+    int growth;
+    size_t align;
+    int mode;
+    int fd;
 } dynabuf_t;
 
 typedef enum {
@@ -24,6 +59,37 @@ typedef enum {
     ALC_DYNABUF_INVALID
 } dynabuf_error_t;
 
+/*
+ * Growth policies, used by containers to choose the next size of a dynabuf
+ * which has run out of space.
+ *  - DOUBLE grows to 2n + 1 elements, the default.
+ *  - HALF grows to 1.5n + 1 elements, which allows the allocator to reuse
+ *    previously freed blocks and lowers peak memory use.
+ *  - PAGE grows like HALF, rounded up to a whole number of pages.
+ */
+typedef enum {
+    ALC_DYNABUF_GROW_DOUBLE = 0,
+    ALC_DYNABUF_GROW_HALF,
+    ALC_DYNABUF_GROW_PAGE
+} dynabuf_growth_t;
+
+#ifndef ALC_DYNABUF_PAGE_SIZE
+#define ALC_DYNABUF_PAGE_SIZE 4096
+#endif
+
+/*
+ * Common alignments for create_dynabuf_aligned.  Buffers aligned to
+ * ALC_DYNABUF_ALIGN_HUGE or more are rounded up to a whole number of huge
+ * pages and marked with MADV_HUGEPAGE where it is available.  Containers use
+ * huge page alignment for tables of at least ALC_DYNABUF_HUGE_THRESHOLD bytes.
+ */
+#define ALC_DYNABUF_ALIGN_CACHELINE 64
+#define ALC_DYNABUF_ALIGN_PAGE      ALC_DYNABUF_PAGE_SIZE
+#define ALC_DYNABUF_ALIGN_HUGE      ((size_t)2 << 20)
+#ifndef ALC_DYNABUF_HUGE_THRESHOLD
+#define ALC_DYNABUF_HUGE_THRESHOLD  ((size_t)4 << 20)
+#endif
+
 /**
  * Create a new dynabuf, with a given size, and an allocation unit size.
  * When accessed using "dynabuf_fetch" and "dynabuf_set", this is the size of
@@ -32,7 +98,75 @@ typedef enum {
  * @param unit the size of each element, in bytes.
  * @return dynabuf_t, or NULL on error.
  */
-dynabuf_t *create_dynabuf(int size, int unit);
+dynabuf_t *create_dynabuf(size_t size, size_t unit);
+
+/**
+ * Create a new dynabuf whose buffer starts on an align-byte boundary.  The
+ * alignment is kept when the dynabuf is resized, at the cost of copying the
+ * contents instead of calling realloc.
+ * @param size the size of the buffer to create, in elements.
+ * @param unit the size of each element, in bytes.
+ * @param align the alignment in bytes, a power of two multiple of
+ * sizeof(void*), such as ALC_DYNABUF_ALIGN_CACHELINE.  0 is the same as
+ * create_dynabuf.
+ * @return dynabuf_t, or NULL on error.
+ */
+dynabuf_t *create_dynabuf_aligned(size_t size, size_t unit, size_t align);
+
+/**
+ * Initialize a dynabuf in caller-provided storage, over a caller-provided
+ * buffer.  No memory is allocated until the dynabuf is resized.  Dynabufs
+ * initialized this way must be cleaned up with dynabuf_release, not
+ * dynabuf_free.
+ * @param target the dynabuf to initialize
+ * @param buf the buffer to use, of at least size*unit bytes.
+ * @param size the size of buf, in elements.
+ * @param unit the size of each element, in bytes.
+ * @return dynabuf_error_t error code.
+ */
+int dynabuf_init(dynabuf_t *target, void *buf, size_t size, size_t unit);
+
+/**
+ * Create a new dynabuf which reserves address space for max elements up
+ * front, and commits memory for size elements.  Resizing commits or releases
+ * pages within the reservation, so the buffer is never copied or moved, and
+ * pointers returned by dynabuf_fetch stay valid across resizes.
+ * @param size the size of the buffer to create, in elements.
+ * @param unit the size of each element, in bytes.
+ * @param max the maximum size the buffer can be resized to, in elements.
+ * @return dynabuf_t, or NULL on error or if reservations are not supported.
+ */
+dynabuf_t *create_dynabuf_reserved(size_t size, size_t unit, size_t max);
+
+/**
+ * Create a new dynabuf backed by a memory-mapped file.  The file is created if
+ * it does not exist, and is extended to hold at least size elements.  If the
+ * file is already larger, its existing contents are kept and capacity covers
+ * the whole file.  Resizing extends or truncates the file.
+ * @param path the file to map
+ * @param size the minimum size of the buffer, in elements.
+ * @param unit the size of each element, in bytes.
+ * @param header the number of bytes at the start of the file to set aside for
+ * caller metadata, see dynabuf_header.
+ * @return dynabuf_t, or NULL on error or if mapping is not supported.
+ */
+dynabuf_t *create_dynabuf_mmap(const char *path, size_t size, size_t unit,
+        size_t header);
+
+/**
+ * Retrieve the metadata area which precedes the elements of a MAPPED dynabuf.
+ * @param target the dynabuf to use
+ * @return pointer to the header bytes, or NULL if the dynabuf has no header.
+ */
+void *dynabuf_header(dynabuf_t *target);
+
+/**
+ * Write any modified contents of a MAPPED dynabuf back to its file.  This is a
+ * no-op for other modes.
+ * @param target the dynabuf to flush
+ * @return dynabuf_error_t error code.
+ */
+int dynabuf_flush(dynabuf_t *target);
 
 /**
  * Insert a new element in the dynabuf.
@@ -41,7 +175,7 @@ dynabuf_t *create_dynabuf(int size, int unit);
  * @param element a pointer to the element which should be written.
  * @return dynabuf_error_t error code.
  */
-int dynabuf_set(dynabuf_t *target, int which, void *element);
+int dynabuf_set(dynabuf_t *target, size_t which, void *element);
 
 
 /**
@@ -60,7 +194,7 @@ int dynabuf_set(dynabuf_t *target, int which, void *element);
  * int next = dynabuf_set_seq(target, index, 0, "hello world", 11);
  * dynabuf_set_seq(target, index, next, 1, sizeof(int));
  */
-int dynabuf_set_seq(dynabuf_t *target, int which, int next,
+int dynabuf_set_seq(dynabuf_t *target, size_t which, int next,
         void *value, int size);
 
 
@@ -70,15 +204,54 @@ int dynabuf_set_seq(dynabuf_t *target, int which, int next,
  * @param idx the element number to retrieve
  * @return the element, or NULL on error.
  */
-void **dynabuf_fetch(dynabuf_t *target, int which);
+void **dynabuf_fetch(dynabuf_t *target, size_t which);
+
+/**
+ * Fetch an element from the dynabuf without any validity checks.
+ * Compiles down to pointer arithmetic, for use in loops where the caller has
+ * already validated the dynabuf and the range of indices.
+ * @param target the dynabuf to fetch from, must be valid.
+ * @param which the element number to retrieve, must be within capacity.
+ * @return the element.
+ */
+static inline void **dynabuf_at(dynabuf_t *target, size_t which) {
+    return (void**)(target->buf + (which * target->elem_size));
+}
 
 /**
  * Resize the dynabuf to a certain size, in elements.
+ * Resizing a RESERVED dynabuf beyond its reservation fails with
+ * ALC_DYNABUF_NO_MEM.
  * @param target the dynabuf whose backing buffer should be resized
  * @param count the number of elements which should be present.
  * @return dynabuf_error_t error code.
  */
-int dynabuf_resize(dynabuf_t *target, int count);
+int dynabuf_resize(dynabuf_t *target, size_t count);
+
+/**
+ * Select the growth policy used by dynabuf_grow_count.
+ * @param target the dynabuf to configure
+ * @param policy dynabuf_growth_t growth policy
+ * @return dynabuf_error_t error code.
+ */
+int dynabuf_set_growth(dynabuf_t *target, int policy);
+
+/**
+ * Compute the number of elements the dynabuf should be resized to when it
+ * runs out of space, according to its growth policy.
+ * @param target the dynabuf which is to be grown
+ * @param min_count the minimum number of elements which must fit.
+ * @return the new size in elements, at least min_count, or zero on error.
+ */
+size_t dynabuf_grow_count(dynabuf_t *target, size_t min_count);
+
+/**
+ * Free the buffer owned by a dynabuf, without freeing the dynabuf itself.
+ * Used for dynabufs set up with dynabuf_init.
+ * @param target the dynabuf whose buffer should be freed
+ */
+void dynabuf_release(dynabuf_t *target);
+
 /**
  * Free the memory associated with a particular dynabuf.
  * @param target the dynabuf to free
@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -19,24 +20,29 @@
 /*
  * Load function type.
  */
-typedef bool (load_type)(int entries, int capacity);
+typedef bool (load_type)(size_t entries, size_t capacity);
 
 /*
  * hashmap type definition
  * _filter is an internal array needed for space-efficiently marking the
  * validity of each entry without using NULL entries or pointers which could
  * cause confusion in the case of a NULL entry being intentional.
+ * _removed marks the slots of removed entries, which stay part of any probe
+ * sequence passing through them until they are reused or the map is rehashed.
+ * removed is the number of such slots.
  */
 typedef struct {
     dynabuf_t *map;
     bitmap_t *_filter;
+    bitmap_t *_removed;
     hash_type *hash;
     load_type *load;
     cmp_type    *compare;
-    int    entries;
-    int    capacity;
+    size_t entries;
+    size_t removed;
+    size_t capacity;
     int    status;
-    int val_offset;
+    size_t val_offset;
 } hashmap_t;
 
 typedef enum {
@@ -58,7 +64,8 @@ typedef enum {
  * @param loadfn memory load estimator, used to reduce collisions.
  * @return new hashmap, or null or errors
  */
-hashmap_t *create_hashmap(int size, int keysz, int valsz, hash_type *hashfn,
+hashmap_t *create_hashmap(size_t size, size_t keysz, size_t valsz,
+        hash_type *hashfn,
         cmp_type *comparefn, load_type loadfn);
 
 /*
@@ -94,14 +101,33 @@ void **hashmap_remove(hashmap_t *self, void *key);
  * @param count the number of entries which should be allocated.
  * @return hashmap_error_t error code.
  */
-int hashmap_resize(hashmap_t *self, int count);
+int hashmap_resize(hashmap_t *self, size_t count);
 
 /*
  * Compute the size in entries of the hashmap
  * @param self the map to use
- * @return the size of the map in elements. 
+ * @return the size of the map in elements, -1 on error.
  */
-int hashmap_size(hashmap_t *self);
+int64_t hashmap_size(hashmap_t *self);
+
+/*
+ * Loop over every entry of a valid hashmap without going through the iterator
+ * interface.  Empty slots are skipped a word of the filter at a time.  key and
+ * val must be void ** variables declared by the caller, and are set to the key
+ * and value of each entry in slot order, as hashmap_fetch would return the
+ * value.  The map must not be modified within the loop.
+ * Example:
+ * void **key, **val;
+ * ALC_HASHMAP_FOREACH(map, key, val) {
+ *     printf("%s: %d\n", *(char**)key, *(int*)val);
+ * }
+ */
+#define ALC_HASHMAP_FOREACH(self, key, val)                                 \
+    for(size_t _alc_i = bitmap_next((self)->_filter, 0, (self)->capacity);  \
+        _alc_i < (self)->capacity                                           \
+            && ((key) = dynabuf_at((self)->map, _alc_i),                    \
+                (val) = (void**)((char*)(key) + (self)->val_offset), 1);    \
+        _alc_i = bitmap_next((self)->_filter, _alc_i + 1, (self)->capacity))
 
 /*
  * Return the memory used to allocate the hashmap and underlying buffers to the
@@ -2,6 +2,30 @@
 #include <alibc/containers/iterator.h>
 #include <alibc/containers/hashmap.h>
 
+/*
+ * The most entries produced by a single batch from an entries iterator.
+ */
+#define ALC_HASHMAP_ENTRY_BATCH 16
+
+/*
+ * A key/value pair yielded by an entries iterator.  key and value point into
+ * the map, exactly as hashmap_fetch would return the value.
+ */
+typedef struct {
+    void **key;
+    void **value;
+} hashmap_entry_t;
+
+/*
+ * Storage for an entries iterator.  Entries are produced into the iterator
+ * itself, so a yielded hashmap_entry_t is only valid until the next call on
+ * the iterator; the key and value it points to are not affected.
+ */
+typedef struct {
+    iter_context ctx;
+    hashmap_entry_t entries[ALC_HASHMAP_ENTRY_BATCH];
+} hashmap_entries_iter_t;
+
 /**
  * Create a new iterator from the given hashmap, starting at the first element.
  * The keys contained in the map are returned.
@@ -18,3 +42,61 @@ iter_context *create_hashmap_keys_iterator(hashmap_t *target);
  * @return a new iterator context, or NULL on error.
  */
 iter_context *create_hashmap_values_iterator(hashmap_t *target);
+
+/**
+ * Create a new iterator from the given hashmap, starting at the first element.
+ * Each key is returned together with its value in a single pass over the map,
+ * as a pointer to a hashmap_entry_t.  iter_next_batch produces at most
+ * ALC_HASHMAP_ENTRY_BATCH entries per call.
+ * @param target The hashmap whose elements will be iterated over
+ * @return a new iterator context, or NULL on error.
+ */
+iter_context *create_hashmap_entries_iterator(hashmap_t *target);
+
+/**
+ * Create new iterators over the entries of the given hashmap which are stored
+ * in the slots [begin, end) of its table.  end may be ALC_ITER_END, and is
+ * clamped to the capacity of the map.  Entries iterators cannot be passed to
+ * iter_split, so these are the way to partition them.
+ * @param target The hashmap whose elements will be iterated over
+ * @param begin the first slot to visit
+ * @param end one past the last slot to visit
+ * @return a new iterator context, or NULL on error.
+ */
+iter_context *create_hashmap_keys_iterator_range(hashmap_t *target,
+        size_t begin, size_t end);
+iter_context *create_hashmap_values_iterator_range(hashmap_t *target,
+        size_t begin, size_t end);
+iter_context *create_hashmap_entries_iterator_range(hashmap_t *target,
+        size_t begin, size_t end);
+
+/**
+ * Initialize an iterator over the keys of the given hashmap in caller-provided
+ * storage.  No memory is allocated.
+ * @param ctx the context to fill in
+ * @param target The hashmap whose keys will be iterated over
+ * @return ALC_ITER_READY, ALC_ITER_NULL if ctx is NULL, or ALC_ITER_INVALID if
+ * target is NULL.
+ */
+int iter_init_hashmap_keys(iter_context *ctx, hashmap_t *target);
+
+/**
+ * Initialize an iterator over the values of the given hashmap in
+ * caller-provided storage.  No memory is allocated.
+ * @param ctx the context to fill in
+ * @param target The hashmap whose values will be iterated over
+ * @return ALC_ITER_READY, ALC_ITER_NULL if ctx is NULL, or ALC_ITER_INVALID if
+ * target is NULL.
+ */
+int iter_init_hashmap_values(iter_context *ctx, hashmap_t *target);
+
+/**
+ * Initialize an iterator over the entries of the given hashmap in
+ * caller-provided storage.  No memory is allocated.  Iterate through
+ * &iter->ctx.
+ * @param iter the entries iterator to fill in
+ * @param target The hashmap whose entries will be iterated over
+ * @return ALC_ITER_READY, ALC_ITER_NULL if iter is NULL, or ALC_ITER_INVALID
+ * if target is NULL.
+ */
+int iter_init_hashmap_entries(hashmap_entries_iter_t *iter, hashmap_t *target);
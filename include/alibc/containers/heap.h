@@ -0,0 +1,160 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/hashmap.h>
+#include <alibc/containers/hashable.h>
+#include <alibc/containers/comparable.h>
+
+/**
+ * alibc/containers heap interface
+ * A d-ary heap priority queue stored in an array_t.  The top of the heap is
+ * the smallest element under the heap's comparator; a reversed comparator
+ * gives a max-heap.  The children of element i are elements d*i + 1 through
+ * d*i + d, so with an arity of 4 the children of a small element share a
+ * cache line and the tree is half as deep as a binary heap.
+ * Guarantees:
+ *  - Constant peek time, logarithmic push/pop/replace_top time.
+ *  - Linear time construction from an array_t.
+ *  - Elements are moved with memcpy through a scratch buffer, never with a
+ *    per-operation allocation.
+ *  - Logarithmic update of any element, for heaps created with
+ *    create_heap_indexed.
+ * Non-Guarantees:
+ *  - Stability.  Elements which compare equal come out in any order.
+ *  - Element addresses.  Elements move as the heap changes.
+ */
+
+/*
+ * heap type definition
+ * data holds the elements in heap order.  scratch holds two elements: the
+ * element being sifted, and the element most recently removed from the top.
+ * positions maps each element to its index in data, and is NULL unless the
+ * heap was created with create_heap_indexed.
+ */
+typedef struct {
+    array_t     *data;
+    dynabuf_t   *scratch;
+    hashmap_t   *positions;
+    cmp_type    *cmp;
+    size_t      arity;
+    int         status;
+} heap_t;
+
+/**
+ * Error codes for heap operations
+ */
+typedef enum {
+    ALC_HEAP_SUCCESS = 0,
+    ALC_HEAP_NO_MEM = INT_MIN,
+    ALC_HEAP_INVALID,
+    ALC_HEAP_INVALID_REQ,
+    ALC_HEAP_EMPTY,
+    ALC_HEAP_NOT_FOUND
+} heap_error_t;
+
+/*
+ * Constructor function for heap type
+ * @param size the number of elements to reserve space for.
+ * @param unit the size of each element
+ * @param arity the number of children of each node, at least 2.
+ * @param cmp the comparator.  As with array_sort, elements of up to
+ * sizeof(void*) bytes are passed by value and larger elements by pointer.
+ * @return new heap, or NULL on errors.
+ */
+heap_t *create_heap(size_t size, size_t unit, size_t arity, cmp_type *cmp);
+
+/*
+ * Constructor function for a heap which tracks the position of every
+ * element, so that elements can be found and updated with heap_update.
+ * Elements must be unique under hash and eq.
+ * @param size the number of elements to reserve space for.
+ * @param unit the size of each element
+ * @param arity the number of children of each node, at least 2.
+ * @param cmp the comparator which orders the heap
+ * @param hash the hash function used to find elements
+ * @param eq the comparator used to identify elements, returning 0 for the
+ * same element.  Unlike cmp, it should not depend on the element's priority.
+ * @return new heap, or NULL on errors.
+ */
+heap_t *create_heap_indexed(size_t size, size_t unit, size_t arity,
+        cmp_type *cmp, hash_type *hash, cmp_type *eq);
+
+/*
+ * Constructor function for a heap holding a copy of an array's elements.
+ * The copy is put in heap order in linear time.
+ * @param src the array to copy
+ * @param arity the number of children of each node, at least 2.
+ * @param cmp the comparator, as for create_heap.
+ * @return new heap, or NULL on errors.
+ */
+heap_t *create_heap_from_array(array_t *src, size_t arity, cmp_type *cmp);
+
+/*
+ * Add an item to the heap
+ * @param self the heap to push to
+ * @param item the item to push, passed as for array_append.  For indexed
+ * heaps, it must not already be in the heap.
+ * @return heap_error_t error code.
+ */
+int heap_push(heap_t *self, void *item);
+
+/*
+ * Retrieve the top of the heap without removing it
+ * @param self the heap to use
+ * @return pointer to the smallest element, or NULL if the heap is empty or on
+ * error.
+ */
+void **heap_peek(heap_t *self);
+
+/*
+ * Remove the top of the heap
+ * @param self the heap to pop from
+ * @return pointer to the removed element, which stays valid until the next
+ * operation on the heap, or NULL if the heap is empty or on error.
+ */
+void **heap_pop(heap_t *self);
+
+/*
+ * Remove the top of the heap and push a new item in a single sift, which is
+ * cheaper than heap_pop followed by heap_push.
+ * @param self the heap to use
+ * @param item the item to push, passed as for heap_push.
+ * @return pointer to the removed element, which stays valid until the next
+ * operation on the heap, or NULL if the heap is empty or on error.
+ */
+void **heap_replace_top(heap_t *self, void *item);
+
+/*
+ * Replace an element of an indexed heap, moving it up or down to its new
+ * place.  This provides decrease-key and increase-key.
+ * @param self the heap to use, created with create_heap_indexed.
+ * @param old the element to replace, passed as for array_append.
+ * @param item the new value, passed as for array_append.  It must be equal to
+ * old under the heap's eq function, or not present in the heap.
+ * @return heap_error_t error code, ALC_HEAP_NOT_FOUND if old is not in the
+ * heap.
+ */
+int heap_update(heap_t *self, void *old, void *item);
+
+/*
+ * Compute the number of elements in the heap
+ * @param self the heap to use
+ * @return the number of elements, -1 on error.
+ */
+int64_t heap_size(heap_t *self);
+
+/*
+ * Return the memory used by the heap to the system.
+ * @param self the heap to free
+ */
+void heap_free(heap_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the heap to validate
+ * @return heap_error_t error code from the previous operation
+ */
+int heap_status(heap_t *self);
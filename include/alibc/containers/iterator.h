@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 /*
  * Iterator interface for alc data structures.
@@ -7,16 +8,51 @@
  * It is considered safe to use iterators only when the underlying data is
  * not being changed.  Consult the documentation for each data structure's
  * implementation for information on MT-safety.
+ *
+ * Contexts are either allocated by the create_*_iterator functions, or
+ * filled in caller-provided storage, such as a stack variable, by the
+ * matching iter_init_* functions.  Nothing in the iterator protocol itself
+ * allocates, so iteration over a context from iter_init_* never touches the
+ * heap.
+ *
+ * An iterator walks the slots [index, end) of its container, where a slot is
+ * an array index or a position in a hash table.  Iterators created over a
+ * range, or produced by iter_split, cover disjoint slots, so each of them may
+ * be walked by a different thread.
  */
 
+/*
+ * Iterator context flags.
+ * ALC_ITER_STATIC marks a context in caller-provided storage, which iter_free
+ * leaves alone.
+ */
+#define ALC_ITER_STATIC (1u << 0)
+/*
+ * ALC_ITER_EMBEDDED marks a context which is the head of a larger iterator
+ * structure, and so cannot be copied by iter_split.
+ */
+#define ALC_ITER_EMBEDDED (1u << 1)
+
+/*
+ * End slot of an iterator which runs to the end of its container, however
+ * large the container is when the iterator reaches it.
+ */
+#define ALC_ITER_END SIZE_MAX
+
 typedef struct _iter_context iter_context;
 typedef void **(iter_next_fn)(iter_context *ctx);
+typedef int (iter_batch_fn)(iter_context *ctx, void **out, int n);
+typedef size_t (iter_limit_fn)(iter_context *ctx);
 
 struct _iter_context {
-    uint32_t index;
+    size_t index;
+    size_t end;
     uint32_t status;
+    uint32_t flags;
     void *_data;
     iter_next_fn *next;
+    iter_batch_fn *next_batch;
+    iter_limit_fn *limit;
 };
 
 typedef enum {
@@ -35,6 +71,33 @@ typedef enum {
  */
 void **iter_next(iter_context *ctx);
 
+/**
+ * Retrieve up to n elements from an iterator in one call.  The elements are
+ * produced in the same order as by iter_next, and batches may be mixed freely
+ * with calls to iter_next.  Iterators which do not provide a batch function
+ * are driven through iter_next.
+ * @param ctx The iterator context which should be used to fetch and update
+ * @param out array of at least n slots, filled with the element pointers
+ * @param n the maximum number of elements to retrieve
+ * @return the number of elements written to out, zero once the iterator is
+ * exhausted, or -1 on error.
+ */
+int iter_next_batch(iter_context *ctx, void **out, int n);
+
+/**
+ * Partition the slots which remain in an iterator into k disjoint ranges of
+ * nearly equal width, for traversal by several threads.  The parts are filled
+ * in caller-provided storage and need not be freed.  ctx itself is unchanged.
+ * Note that for hashed containers the parts hold equal numbers of slots, not
+ * necessarily equal numbers of elements.
+ * @param ctx the iterator to partition
+ * @param parts array of at least k contexts to fill in
+ * @param k the number of parts wanted
+ * @return the number of parts filled, which is less than k when fewer than k
+ * slots remain, or -1 on error.
+ */
+int iter_split(iter_context *ctx, iter_context *parts, int k);
+
 /**
  * Retrieve the status of an iterator.
  * @param ctx The iterator to determine the status of
@@ -44,8 +107,20 @@ int iter_status(iter_context *ctx);
 
 /**
  * Free the memory associated with an iterator.  Does not affect the underlying
- * data structure.
+ * data structure.  Contexts filled by an iter_init_* function are not freed,
+ * so code which is handed an iterator can always release it with this call.
  * @param ctx the iterator to free
  * @return none
  */
 void iter_free(iter_context *ctx);
+
+/*
+ * Clamp the end of an iterator's range to the number of slots in its
+ * container.  For use by iterator implementations.
+ * @param ctx the iterator
+ * @param limit the number of slots in the container
+ * @return one past the last slot which the iterator may visit.
+ */
+static inline size_t iter_end(iter_context *ctx, size_t limit) {
+    return (ctx->end < limit) ? ctx->end:limit;
+}
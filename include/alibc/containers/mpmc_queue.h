@@ -0,0 +1,137 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <alibc/containers/dynabuf.h>
+
+/**
+ * alibc/containers mpmc_queue interface
+ * A bounded lock-free queue for any number of producer and consumer threads.
+ * Each slot of the dynabuf-backed ring carries a sequence number which tells
+ * producers and consumers whether the slot is ready for them, so threads only
+ * contend on the shared enqueue and dequeue counters.
+ * Guarantees:
+ *  - MT-safety for any number of producers and consumers.
+ *  - FIFO order of slots.  Elements pushed by one producer are popped in the
+ *    order they were pushed.
+ *  - try_* operations never block or take a lock.
+ * Non-Guarantees:
+ *  - Growth.  Pushing to a full queue fails, or waits in the blocking
+ *    variants.
+ *  - Fairness between waiting threads.
+ */
+
+#define ALC_MPMC_QUEUE_CACHELINE 64
+
+/*
+ * mpmc_queue type definition
+ * cells is a dynabuf of cell_size records, each holding an atomic sequence
+ * number followed by one element.  A cell whose sequence equals a producer's
+ * position is free to fill, and one whose sequence is one past a consumer's
+ * position is ready to drain.  The two counters are kept on separate cache
+ * lines.  There is no status field, since every thread would write it; every
+ * operation returns its status instead.
+ */
+typedef struct {
+    _Alignas(ALC_MPMC_QUEUE_CACHELINE) atomic_size_t enqueue_pos;
+    _Alignas(ALC_MPMC_QUEUE_CACHELINE) atomic_size_t dequeue_pos;
+    _Alignas(ALC_MPMC_QUEUE_CACHELINE) dynabuf_t *cells;
+    size_t mask;
+    size_t elem_size;
+} mpmc_queue_t;
+
+/**
+ * Error codes for mpmc_queue operations
+ */
+typedef enum {
+    ALC_MPMC_QUEUE_SUCCESS = 0,
+    ALC_MPMC_QUEUE_NO_MEM = INT_MIN,
+    ALC_MPMC_QUEUE_INVALID,
+    ALC_MPMC_QUEUE_FULL,
+    ALC_MPMC_QUEUE_EMPTY
+} mpmc_queue_error_t;
+
+/*
+ * Constructor function for mpmc_queue type
+ * @param size the capacity of the queue, rounded up to a power of two.
+ * @param unit the size of each element
+ * @return new queue, or NULL on errors.
+ */
+mpmc_queue_t *create_mpmc_queue(size_t size, size_t unit);
+
+/*
+ * Push an item if there is room.
+ * @param self the queue to push to
+ * @param item the item to push, passed as for dynabuf_set.
+ * @return mpmc_queue_error_t error code, ALC_MPMC_QUEUE_FULL if there is no
+ * room.
+ */
+int mpmc_queue_try_push(mpmc_queue_t *self, void *item);
+
+/*
+ * Push an item, spinning and then yielding the CPU until there is room.
+ * @param self the queue to push to
+ * @param item the item to push, passed as for dynabuf_set.
+ * @return mpmc_queue_error_t error code
+ */
+int mpmc_queue_push(mpmc_queue_t *self, void *item);
+
+/*
+ * Pop an item if there is one.
+ * @param self the queue to pop from
+ * @param dest receives the element, must hold the queue's element size.
+ * @return mpmc_queue_error_t error code, ALC_MPMC_QUEUE_EMPTY if there was
+ * nothing to pop.
+ */
+int mpmc_queue_try_pop(mpmc_queue_t *self, void *dest);
+
+/*
+ * Pop an item, spinning and then yielding the CPU until there is one.
+ * @param self the queue to pop from
+ * @param dest receives the element, must hold the queue's element size.
+ * @return mpmc_queue_error_t error code
+ */
+int mpmc_queue_pop(mpmc_queue_t *self, void *dest);
+
+/*
+ * Push up to count items, claiming all of their slots at once.
+ * @param self the queue to push to
+ * @param src count elements, packed back to back.
+ * @param count the number of elements in src
+ * @return the number of elements pushed, which is less than count if the
+ * queue filled up, or a negative mpmc_queue_error_t code on error.
+ */
+int64_t mpmc_queue_try_push_n(mpmc_queue_t *self, const void *src,
+        size_t count);
+
+/*
+ * Pop up to count items, claiming all of their slots at once.
+ * @param self the queue to pop from
+ * @param dest receives the elements, packed back to back.
+ * @param count the maximum number of elements to pop
+ * @return the number of elements popped, or a negative mpmc_queue_error_t
+ * code on error.
+ */
+int64_t mpmc_queue_try_pop_n(mpmc_queue_t *self, void *dest, size_t count);
+
+/*
+ * Estimate the number of elements in the queue.  The result is approximate
+ * while other threads are active.
+ * @param self the queue to use
+ * @return the number of elements, -1 on error.
+ */
+int64_t mpmc_queue_size(mpmc_queue_t *self);
+
+/*
+ * Compute the capacity of the queue
+ * @param self the queue to use
+ * @return the number of elements the queue can hold, -1 on error.
+ */
+int64_t mpmc_queue_capacity(mpmc_queue_t *self);
+
+/*
+ * Free the queue.  No thread may use it afterwards.
+ * @param self the queue to free
+ */
+void mpmc_queue_free(mpmc_queue_t *self);
@@ -0,0 +1,157 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <alibc/containers/dynabuf.h>
+
+/**
+ * alibc/containers pool interface
+ * A fixed-size object pool (slab allocator).  Objects are carved out of large
+ * dynabuf-backed chunks, and released objects are kept on a free list which is
+ * threaded through the objects themselves.
+ * Guarantees:
+ *  - Constant alloc/release time
+ *  - Stable addresses: chunks are never moved or reallocated, so an object
+ *    stays at the same address until it is released.
+ *  - Objects are aligned to ALC_POOL_ALIGN, or to ALC_POOL_CACHELINE when the
+ *    pool is created with ALC_POOL_ALIGNED.
+ * Non-Guarantees:
+ *  - Object contents are not preserved across release/alloc.
+ *  - Memory is only returned to the system when the pool is freed.
+ *  - MT-safety, unless the pool is created with ALC_POOL_SHARED.
+ */
+
+#define ALC_POOL_ALIGN      (2*sizeof(void*))
+#define ALC_POOL_CACHELINE  64
+
+/*
+ * Creation flags for pools, may be OR'd together.
+ */
+typedef enum {
+    ALC_POOL_DEFAULT    = 0,
+    // align every object to a cache line
+    ALC_POOL_ALIGNED    = 1 << 0,
+    // guard the pool with a mutex, required for use with pool_cache_t
+    ALC_POOL_SHARED     = 1 << 1
+} pool_flags_t;
+
+/*
+ * pool type definition
+ * chunks is a dynabuf of dynabuf_t pointers, one for each slab which has been
+ * allocated.  carve and carve_end delimit the never-used tail of the newest
+ * chunk, so that a chunk does not need to be walked when it is created.
+ */
+typedef struct {
+    dynabuf_t       *chunks;
+    void            *free_list;
+    char            *carve;
+    char            *carve_end;
+    pthread_mutex_t *lock;
+    size_t  obj_size;
+    size_t  align;
+    size_t  chunk_objs;
+    size_t  nchunks;
+    size_t  live;
+    int     status;
+} pool_t;
+
+/*
+ * Per-thread cache of pool objects.
+ * A cache is owned by exactly one thread, and keeps up to limit released
+ * objects on a private free list so that the shared pool lock is only taken
+ * once per batch of allocations or releases.
+ */
+typedef struct {
+    pool_t  *pool;
+    void    *free_list;
+    int     count;
+    int     limit;
+} pool_cache_t;
+
+/**
+ * Error codes for pool operations
+ */
+typedef enum {
+    ALC_POOL_SUCCESS = 0,
+    ALC_POOL_NO_MEM = INT_MIN,
+    ALC_POOL_INVALID,
+    ALC_POOL_INVALID_REQ
+} pool_error_t;
+
+/*
+ * Constructor function for pool type
+ * @param unit the size of each object, in bytes.
+ * @param chunk_objs the number of objects carved out of each chunk.
+ * @param flags pool_flags_t creation flags.
+ * @return new pool, or NULL on errors.
+ */
+pool_t *create_pool(size_t unit, size_t chunk_objs, int flags);
+
+/*
+ * Allocate an object from the pool
+ * @param self the pool to allocate from
+ * @return pointer to uninitialized storage for one object, or NULL on error.
+ */
+void *pool_alloc(pool_t *self);
+
+/*
+ * Return an object to the pool.  The object must have been allocated from
+ * this pool, and must not be used after this call.
+ * @param self the pool which the object was allocated from
+ * @param obj the object to release
+ * @return ALC_POOL_* error code
+ */
+int pool_release(pool_t *self, void *obj);
+
+/*
+ * Compute the number of objects currently allocated from the pool.
+ * @param self the pool to use
+ * @return the number of live objects, -1 on error.
+ */
+int64_t pool_size(pool_t *self);
+
+/*
+ * Return all memory used by the pool to the system.  Every object allocated
+ * from the pool becomes invalid.
+ * @param self the pool to free
+ */
+void pool_free(pool_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the pool to validate
+ * @return ALC_POOL_* error code corresponding to the most recent operation
+ */
+int pool_status(pool_t *self);
+
+/*
+ * Initialize a per-thread cache in caller-provided storage.
+ * @param cache the cache to initialize
+ * @param pool the shared pool backing this cache, created with ALC_POOL_SHARED
+ * @param limit the maximum number of objects held by the cache
+ * @return ALC_POOL_* error code
+ */
+int pool_cache_init(pool_cache_t *cache, pool_t *pool, int limit);
+
+/*
+ * Allocate an object through a per-thread cache.
+ * @param cache the cache to use
+ * @return pointer to uninitialized storage for one object, or NULL on error.
+ */
+void *pool_cache_alloc(pool_cache_t *cache);
+
+/*
+ * Release an object through a per-thread cache.
+ * @param cache the cache to use
+ * @param obj the object to release
+ * @return ALC_POOL_* error code
+ */
+int pool_cache_release(pool_cache_t *cache, void *obj);
+
+/*
+ * Return every object held by the cache to the shared pool.  Must be called
+ * before the owning thread exits.
+ * @param cache the cache to flush
+ */
+void pool_cache_flush(pool_cache_t *cache);
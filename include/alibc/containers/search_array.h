@@ -0,0 +1,91 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/comparable.h>
+
+/**
+ * alibc/containers search_array interface
+ * A read-only copy of a sorted array, stored in Eytzinger (breadth-first
+ * binary tree) order.  Searches walk the tree from the root, so the first
+ * levels of every search share the same few cache lines, and the descendants
+ * a few levels down are contiguous and can be prefetched ahead of time.
+ * Searches do not branch on comparison results.
+ * Guarantees:
+ *  - Logarithmic find/lower_bound time, with fewer cache misses than a
+ *    binary search of the sorted array.
+ * Non-Guarantees:
+ *  - Modification.  The contents are fixed when the search_array is created.
+ *  - Sorted iteration order; elements are stored in tree order.
+ */
+
+/*
+ * search_array type definition
+ * data holds size + 1 elements; the tree is 1-indexed, so the children of
+ * element k are elements 2k and 2k + 1, and element 0 is unused.
+ */
+typedef struct {
+    dynabuf_t   *data;
+    size_t      size;
+    cmp_type    *cmp;
+    int         status;
+} search_array_t;
+
+/**
+ * Error codes for search_array operations
+ */
+typedef enum {
+    ALC_SEARCH_ARRAY_SUCCESS = 0,
+    ALC_SEARCH_ARRAY_NO_MEM = INT_MIN,
+    ALC_SEARCH_ARRAY_INVALID,
+    ALC_SEARCH_ARRAY_NOT_FOUND
+} search_array_error_t;
+
+/*
+ * Constructor function for search_array type
+ * @param sorted an array sorted in ascending order of cmp, which is copied.
+ * @param cmp the comparator the array is sorted by, as for array_sort.  The
+ * element is always passed as the first argument and the key as the second.
+ * @return new search_array, or NULL on errors.
+ */
+search_array_t *create_search_array(array_t *sorted, cmp_type *cmp);
+
+/*
+ * Find an element equal to key
+ * @param self the search_array to search
+ * @param key the key to search for, passed as an element would be.
+ * @return pointer to the first equal element in sorted order, or NULL if
+ * there is none or on error.
+ */
+void **search_array_find(search_array_t *self, void *key);
+
+/*
+ * Find the first element, in sorted order, which is not less than key
+ * @param self the search_array to search
+ * @param key the key to search for, passed as an element would be.
+ * @return pointer to the element, or NULL if every element is less than key
+ * or on error.
+ */
+void **search_array_lower_bound(search_array_t *self, void *key);
+
+/*
+ * Compute the number of elements in the search_array
+ * @param self the search_array to use
+ * @return the number of elements, -1 on error.
+ */
+int64_t search_array_size(search_array_t *self);
+
+/*
+ * Free the search_array.  Elements of the source array are not affected.
+ * @param self the search_array to free
+ */
+void search_array_free(search_array_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the search_array to validate
+ * @return search_array_error_t error code of the most recent operation
+ */
+int search_array_status(search_array_t *self);
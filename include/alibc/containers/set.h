@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
@@ -19,7 +20,7 @@
 /*
  * function typedefs
  */
-typedef bool (load_type)(int entries, int capacity);
+typedef bool (load_type)(size_t entries, size_t capacity);
 
 
 // load function?
@@ -29,8 +30,8 @@ typedef struct {
     hash_type   *hash;
     load_type *load;
     cmp_type  *compare;
-    int  entries;
-    int  capacity;
+    size_t entries;
+    size_t capacity;
     int  status;
 } set_t;
 
@@ -55,7 +56,7 @@ typedef enum {
  * @param loadfn memory load estimator, for use to reduce collisions.
  * @return pointer to a new set on the heap, or NULL on errors.
  */
-set_t *create_set(int size, int unit, hash_type *hashfn,
+set_t *create_set(size_t size, size_t unit, hash_type *hashfn,
         cmp_type *comparefn, load_type loadfn);
 
 /*
@@ -97,7 +98,7 @@ int set_contains(set_t *self, void *item);
  * @param count the number of elements which this set should be able to hold.
  * @return set_status;
  */
-int set_resize(set_t *self, int count);
+int set_resize(set_t *self, size_t count);
 
 /* Retrieve an array-like object from the set which can be iterated over.
  * @param self the set which should be iterated over
@@ -116,7 +117,7 @@ int set_resize(set_t *self, int count);
  * @param self the set to use
  * @return the number of entries, or -1 on failure.
  */
-int set_size(set_t *self);
+int64_t set_size(set_t *self);
 
 /*
  * Return the status of the most recent set operation.
@@ -124,6 +125,23 @@ int set_size(set_t *self);
  */
 int set_status(set_t *self);
 
+/*
+ * Loop over every member of a valid set without going through the iterator
+ * interface.  Empty slots are skipped a word of the filter at a time.  item
+ * must be a void ** declared by the caller, and is set to each member in slot
+ * order.  The set must not be modified within the loop.
+ * Example:
+ * void **item;
+ * ALC_SET_FOREACH(set, item) {
+ *     puts(*(char**)item);
+ * }
+ */
+#define ALC_SET_FOREACH(self, item)                                         \
+    for(size_t _alc_i = bitmap_next((self)->_filter, 0, (self)->capacity);  \
+        _alc_i < (self)->capacity                                           \
+            && ((item) = dynabuf_at((self)->buf, _alc_i), 1);               \
+        _alc_i = bitmap_next((self)->_filter, _alc_i + 1, (self)->capacity))
+
 /*
  * Destroy the set and free all memory allocated by it.
  * @param self the set to destroy
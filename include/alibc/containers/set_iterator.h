@@ -8,3 +8,25 @@
  * @return a new iterator context, or NULL on error.
  */
 iter_context *create_set_iterator(set_t *target);
+
+/**
+ * Create a new iterator over the members of the given set which are stored in
+ * the slots [begin, end) of its table.  end may be ALC_ITER_END, and is
+ * clamped to the capacity of the set.
+ * @param target The set whose elements will be iterated over
+ * @param begin the first slot to visit
+ * @param end one past the last slot to visit
+ * @return a new iterator context, or NULL on error.
+ */
+iter_context *create_set_iterator_range(set_t *target, size_t begin,
+        size_t end);
+
+/**
+ * Initialize an iterator over the given set in caller-provided storage,
+ * starting at the first element.  No memory is allocated.
+ * @param ctx the context to fill in
+ * @param target The set whose elements will be iterated over
+ * @return ALC_ITER_READY, ALC_ITER_NULL if ctx is NULL, or ALC_ITER_INVALID if
+ * target is NULL.
+ */
+int iter_init_set(iter_context *ctx, set_t *target);
@@ -0,0 +1,145 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <alibc/containers/dynabuf.h>
+/**
+ * alibc/containers small_array interface
+ * An array which stores its first few elements inline, in the same
+ * allocation as the array header.  The array moves to a heap buffer only when
+ * it outgrows its inline storage, so short arrays cost a single malloc and
+ * fetches chase a single pointer.
+ * Guarantees:
+ *  - contiguous allocation
+ *  - Constant fetch/append time
+ *  - Constant insert/remove time
+ *  - Memory-safe - objects stored must be deallocated on their own.
+ * Non-Guarantees:
+ *  - Ordering.  As with array_t, insertion and removal change the order of
+ *    stored objects.
+ *  - Stable addresses.  Elements move to the heap when the inline storage
+ *    overflows, and are never moved back.
+ */
+
+/*
+ * small_array type definition
+ * data is embedded rather than pointed to; its buffer points at _inline until
+ * the array outgrows it.  Values follow the same convention as array_t.
+ */
+typedef struct {
+    dynabuf_t   data;
+    size_t      size;
+    int         status;
+    max_align_t _inline[];
+} small_array_t;
+
+/**
+ * Error codes for small_array operations
+ */
+typedef enum {
+    ALC_SMALL_ARRAY_SUCCESS = 0,
+    ALC_SMALL_ARRAY_IDX_OOB = INT_MIN,
+    ALC_SMALL_ARRAY_INVALID,
+    ALC_SMALL_ARRAY_NO_MEM
+} small_array_error_t;
+
+/*
+ * Constructor function for small_array type
+ * @param size the number of elements to store inline.
+ * @param unit the size of each array element
+ * @return new array, or null on errors.
+ */
+small_array_t *create_small_array(size_t size, size_t unit);
+
+/*
+ * Insert an item into the array.  The item previously at where is moved to
+ * the end of the array.
+ * @param self the array to insert into
+ * @param where the index to insert at, at most the size of the array.
+ * @param item the item to insert.
+ * @return small_array_error_t error code
+ */
+int small_array_insert(small_array_t *self, size_t where, void *item);
+
+/*
+ * Append an item to the end of the array
+ * @param self the array to append to
+ * @param item the item to append.
+ * @return small_array_error_t error code
+ */
+int small_array_append(small_array_t *self, void *item);
+
+/*
+ * Fetch an item from the array
+ * @param self the array to fetch from
+ * @param which the index of the item
+ * @return pointer to the item, or NULL on error
+ */
+void **small_array_fetch(small_array_t *self, size_t which);
+
+/*
+ * Remove an item from the array.  The last item of the array takes its place.
+ * @param self the array to remove from
+ * @param which the index of the item
+ * @return pointer to the removed item, valid until the next modification, or
+ * NULL on error.
+ */
+void **small_array_remove(small_array_t *self, size_t which);
+
+/*
+ * Grow the array storage to hold at least count elements.  Growing past the
+ * inline storage moves the elements to the heap.
+ * @param self the array to resize
+ * @param count the number of elements to make room for
+ * @return small_array_error_t error code
+ */
+int small_array_resize(small_array_t *self, size_t count);
+
+/*
+ * Report whether the array still uses its inline storage.
+ * @param self the array to check
+ * @return true if no heap buffer has been allocated.
+ */
+bool small_array_is_inline(small_array_t *self);
+
+/*
+ * Compute the size of the array
+ * @param self the array to use
+ * @return the number of elements in the array, -1 on error.
+ */
+int64_t small_array_size(small_array_t *self);
+
+/*
+ * Free the array and any heap storage it uses.
+ * @param self the array to free
+ */
+void small_array_free(small_array_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the array to validate
+ * @return small_array_error_t error code of the most recent operation
+ */
+int small_array_status(small_array_t *self);
+
+/*
+ * Pointer to the first element of the array.  Not bounds- or NULL-checked.
+ * @param self the array to use, must be valid.
+ * @return pointer to the first element.
+ */
+static inline void *small_array_data(small_array_t *self) {
+    return self->data.buf;
+}
+
+/*
+ * Fetch an item without any checks, for hot loops which have already
+ * validated the array and the index.
+ * @param self the array to fetch from, must be valid.
+ * @param which the index of the item, must be less than the array size.
+ * @return pointer to the item, as with small_array_fetch.
+ */
+static inline void **small_array_at_unchecked(
+        small_array_t *self, size_t which) {
+    return dynabuf_at(&self->data, which);
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <alibc/containers/dynabuf.h>
+
+/**
+ * alibc/containers soa interface
+ * A structure-of-arrays table.  Each field of a row is stored in its own
+ * column, a cache line aligned dynabuf, so a loop over one field reads only
+ * that field's bytes and can be vectorized over the column directly.
+ * Guarantees:
+ *  - Each column is contiguous and aligned to ALC_DYNABUF_ALIGN_CACHELINE.
+ *  - Constant append/fetch/remove time.
+ *  - Every column has the same number of rows.
+ * Non-Guarantees:
+ *  - Ordering.  As with array_t, removal moves the last row into the gap.
+ *  - Stable addresses.  Columns move when the table grows.
+ */
+
+/*
+ * soa type definition
+ * columns holds one dynabuf per field, each with room for capacity rows.
+ */
+typedef struct {
+    size_t      nfields;
+    size_t      size;
+    size_t      capacity;
+    int         status;
+    dynabuf_t   *columns[];
+} soa_t;
+
+/**
+ * Error codes for soa operations
+ */
+typedef enum {
+    ALC_SOA_SUCCESS = 0,
+    ALC_SOA_IDX_OOB = INT_MIN,
+    ALC_SOA_INVALID,
+    ALC_SOA_NO_MEM
+} soa_error_t;
+
+/*
+ * Constructor function for soa type
+ * @param size the number of rows to reserve space for.
+ * @param field_sizes the size in bytes of each field
+ * @param nfields the number of fields in each row
+ * @return new table, or NULL on errors.
+ */
+soa_t *create_soa(size_t size, const size_t *field_sizes, size_t nfields);
+
+/*
+ * Append a row to the end of the table
+ * @param self the table to append to
+ * @param fields nfields values, one per field.  Following the dynabuf
+ * convention, fields of up to sizeof(void*) bytes are passed by value and
+ * larger fields by pointer.
+ * @return soa_error_t error code
+ */
+int soa_append(soa_t *self, void **fields);
+
+/*
+ * Overwrite one field of a row
+ * @param self the table to use
+ * @param row the index of the row
+ * @param field the index of the field
+ * @param item the value, passed as for soa_append.
+ * @return soa_error_t error code
+ */
+int soa_set(soa_t *self, size_t row, size_t field, void *item);
+
+/*
+ * Fetch one field of a row
+ * @param self the table to fetch from
+ * @param row the index of the row
+ * @param field the index of the field
+ * @return pointer to the field, or NULL on error.
+ */
+void **soa_fetch(soa_t *self, size_t row, size_t field);
+
+/*
+ * Fetch every field of a row
+ * @param self the table to fetch from
+ * @param row the index of the row
+ * @param out receives nfields pointers, one to each field of the row.
+ * @return soa_error_t error code
+ */
+int soa_fetch_row(soa_t *self, size_t row, void ***out);
+
+/*
+ * Remove a row.  The last row of the table takes its place.
+ * @param self the table to remove from
+ * @param row the index of the row
+ * @return soa_error_t error code
+ */
+int soa_remove(soa_t *self, size_t row);
+
+/*
+ * Retrieve the column of a field, for scans over a single field.  The
+ * pointer is invalidated by any operation which grows the table.
+ * @param self the table to use
+ * @param field the index of the field
+ * @return pointer to the field of the first row, or NULL on error.
+ */
+void *soa_column(soa_t *self, size_t field);
+
+/*
+ * Grow every column to hold at least count rows.
+ * @param self the table to resize
+ * @param count the number of rows to make room for
+ * @return soa_error_t error code
+ */
+int soa_resize(soa_t *self, size_t count);
+
+/*
+ * Compute the number of rows in the table
+ * @param self the table to use
+ * @return the number of rows, -1 on error.
+ */
+int64_t soa_size(soa_t *self);
+
+/*
+ * Free the table and all of its columns.
+ * @param self the table to free
+ */
+void soa_free(soa_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the table to validate
+ * @return soa_error_t error code of the most recent operation
+ */
+int soa_status(soa_t *self);
+
+/*
+ * Fetch one field of a row without any checks, for hot loops which have
+ * already validated the table and the indices.
+ * @param self the table to fetch from, must be valid.
+ * @param row the index of the row, must be less than the table size.
+ * @param field the index of the field, must be less than nfields.
+ * @return pointer to the field, as with soa_fetch.
+ */
+static inline void **soa_at_unchecked(soa_t *self, size_t row, size_t field) {
+    return dynabuf_at(self->columns[field], row);
+}
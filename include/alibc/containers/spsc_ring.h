@@ -0,0 +1,117 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <alibc/containers/dynabuf.h>
+
+/**
+ * alibc/containers spsc_ring interface
+ * A bounded lock-free queue for exactly one producer thread and one consumer
+ * thread.  Elements are fixed-size and are copied into and out of a
+ * power-of-two sized dynabuf.
+ * Guarantees:
+ *  - FIFO order.
+ *  - Constant push/pop time, without locks or system calls.
+ *  - Batch push/pop copy each contiguous run of slots with one memcpy.
+ * Non-Guarantees:
+ *  - MT-safety with more than one producer or more than one consumer.
+ *  - Growth.  Pushing to a full ring fails.
+ */
+
+#define ALC_SPSC_RING_CACHELINE 64
+
+/*
+ * spsc_ring type definition
+ * head and tail are free-running counters of popped and pushed elements.
+ * Each side keeps a cached copy of the other side's counter, and only reads
+ * the shared one when the cache says the ring is full or empty.  The producer
+ * fields, consumer fields and shared read-only fields are kept on separate
+ * cache lines.  There is no status field, since both threads would write it;
+ * every operation returns its status instead.
+ */
+typedef struct {
+    _Alignas(ALC_SPSC_RING_CACHELINE) atomic_size_t tail;
+    size_t cached_head;
+    _Alignas(ALC_SPSC_RING_CACHELINE) atomic_size_t head;
+    size_t cached_tail;
+    _Alignas(ALC_SPSC_RING_CACHELINE) dynabuf_t *buf;
+    size_t mask;
+} spsc_ring_t;
+
+/**
+ * Error codes for spsc_ring operations
+ */
+typedef enum {
+    ALC_SPSC_RING_SUCCESS = 0,
+    ALC_SPSC_RING_NO_MEM = INT_MIN,
+    ALC_SPSC_RING_INVALID,
+    ALC_SPSC_RING_FULL,
+    ALC_SPSC_RING_EMPTY
+} spsc_ring_error_t;
+
+/*
+ * Constructor function for spsc_ring type
+ * @param size the capacity of the ring, rounded up to a power of two.
+ * @param unit the size of each element
+ * @return new ring, or NULL on errors.
+ */
+spsc_ring_t *create_spsc_ring(size_t size, size_t unit);
+
+/*
+ * Push an item.  Producer thread only.
+ * @param self the ring to push to
+ * @param item the item to push, passed as for dynabuf_set.
+ * @return spsc_ring_error_t error code, ALC_SPSC_RING_FULL if there is no room.
+ */
+int spsc_ring_push(spsc_ring_t *self, void *item);
+
+/*
+ * Pop an item.  Consumer thread only.
+ * @param self the ring to pop from
+ * @param dest receives the element, must hold the ring's element size.
+ * @return spsc_ring_error_t error code, ALC_SPSC_RING_EMPTY if there was
+ * nothing to pop.
+ */
+int spsc_ring_pop(spsc_ring_t *self, void *dest);
+
+/*
+ * Push up to count items.  Producer thread only.
+ * @param self the ring to push to
+ * @param src count elements, packed back to back.
+ * @param count the number of elements in src
+ * @return the number of elements pushed, which is less than count if the ring
+ * filled up, or a negative spsc_ring_error_t code on error.
+ */
+int64_t spsc_ring_push_n(spsc_ring_t *self, const void *src, size_t count);
+
+/*
+ * Pop up to count items.  Consumer thread only.
+ * @param self the ring to pop from
+ * @param dest receives the elements, packed back to back.
+ * @param count the maximum number of elements to pop
+ * @return the number of elements popped, or a negative spsc_ring_error_t code
+ * on error.
+ */
+int64_t spsc_ring_pop_n(spsc_ring_t *self, void *dest, size_t count);
+
+/*
+ * Compute the number of elements in the ring.  The result may be out of date
+ * by the time it is returned if the other thread is active.
+ * @param self the ring to use
+ * @return the number of elements, -1 on error.
+ */
+int64_t spsc_ring_size(spsc_ring_t *self);
+
+/*
+ * Compute the capacity of the ring
+ * @param self the ring to use
+ * @return the number of elements the ring can hold, -1 on error.
+ */
+int64_t spsc_ring_capacity(spsc_ring_t *self);
+
+/*
+ * Free the ring.  Neither thread may use it afterwards.
+ * @param self the ring to free
+ */
+void spsc_ring_free(spsc_ring_t *self);
@@ -0,0 +1,97 @@
+#pragma once
+#include <stddef.h>
+#include <limits.h>
+#include <pthread.h>
+
+/**
+ * alibc/containers thread pool interface
+ * A small fork-join worker pool, used by the parallel container algorithms.
+ * Work is submitted as a batch of numbered tasks; the submitting thread helps
+ * run the batch and returns once every task has finished.
+ * Guarantees:
+ *  - Every task of a batch runs exactly once.
+ *  - Memory written by tasks is visible to the submitting thread once
+ *    thread_pool_run returns.
+ * Non-Guarantees:
+ *  - Task order, or which thread runs a given task.
+ *  - Re-entrancy.  Tasks must not submit work to the pool running them, and
+ *    only one thread may submit work to a pool at a time.
+ */
+
+/*
+ * Task function type
+ * @param arg the argument given to thread_pool_run
+ * @param task the index of this task within its batch
+ */
+typedef void (task_fn)(void *arg, size_t task);
+
+/*
+ * thread pool type definition
+ * A batch is published by bumping generation.  Tasks are claimed by
+ * incrementing next, and the submitter waits on done until pending reaches
+ * zero.  All of these are guarded by lock; tasks are expected to be coarse.
+ */
+typedef struct {
+    pthread_t       *threads;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    pthread_cond_t  done;
+    task_fn         *fn;
+    void            *arg;
+    size_t          ntasks;
+    size_t          next;
+    size_t          pending;
+    size_t          generation;
+    int             nthreads;
+    int             shutdown;
+    int             status;
+} thread_pool_t;
+
+/**
+ * Error codes for thread pool operations
+ */
+typedef enum {
+    ALC_THREAD_POOL_SUCCESS = 0,
+    ALC_THREAD_POOL_NO_MEM = INT_MIN,
+    ALC_THREAD_POOL_INVALID,
+    ALC_THREAD_POOL_FAILURE
+} thread_pool_error_t;
+
+/*
+ * Constructor function for thread pool type
+ * @param nthreads the number of threads which run tasks, including the
+ * submitting thread.  0 uses one thread per online CPU.
+ * @return new thread pool, or NULL on errors.
+ */
+thread_pool_t *create_thread_pool(int nthreads);
+
+/*
+ * Run fn(arg, i) for every i in [0, ntasks), and wait for all of them.
+ * @param self the pool to run the tasks on
+ * @param fn the task function
+ * @param arg argument passed to every task
+ * @param ntasks the number of tasks in the batch
+ * @return thread_pool_error_t error code
+ */
+int thread_pool_run(thread_pool_t *self, task_fn *fn, void *arg,
+        size_t ntasks);
+
+/*
+ * Compute the number of threads which run tasks, including the submitter.
+ * @param self the pool to use
+ * @return the number of threads, -1 on error.
+ */
+int thread_pool_size(thread_pool_t *self);
+
+/*
+ * Stop and join the worker threads, and free the pool.
+ * @param self the pool to free
+ */
+void thread_pool_free(thread_pool_t *self);
+
+/*
+ * Ascertain the status of the previous operation
+ * @param self the pool to validate
+ * @return thread_pool_error_t error code of the most recent operation
+ */
+int thread_pool_status(thread_pool_t *self);
@@ -0,0 +1,106 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <alibc/containers/dynabuf.h>
+
+/**
+ * alibc/containers ws_deque interface
+ * A Chase-Lev work-stealing deque of pointers.  One owner thread pushes and
+ * pops at the bottom, like a stack, while any number of thief threads steal
+ * from the top.  The owner only synchronizes with thieves when they compete
+ * for the last element.
+ * Guarantees:
+ *  - MT-safety for one owner and any number of thieves.
+ *  - push and pop are lock-free, and wait-free unless the deque is nearly
+ *    empty.  steal is lock-free.
+ *  - The deque grows as needed.  Growth copies the live elements to a buffer
+ *    twice the size, and only the owner ever waits on it.
+ * Non-Guarantees:
+ *  - Memory is not returned before the deque is freed.  Buffers replaced by
+ *    growth are kept, since a thief may still be reading them.
+ *  - Elements other than pointers.  Slots must be read and written
+ *    atomically, so they are exactly one pointer wide.
+ */
+
+#define ALC_WS_DEQUE_CACHELINE 64
+
+/*
+ * ws_deque type definition
+ * top and bottom are signed so that a pop racing with a steal for the last
+ * element may briefly move bottom below top.  buf is a power-of-two sized
+ * dynabuf of pointers indexed by position modulo its size.  retired is a
+ * dynabuf of the nretired buffers replaced by growth, and is only touched by
+ * the owner.
+ */
+typedef struct {
+    _Alignas(ALC_WS_DEQUE_CACHELINE) _Atomic int64_t top;
+    _Alignas(ALC_WS_DEQUE_CACHELINE) _Atomic int64_t bottom;
+    _Atomic(dynabuf_t*) buf;
+    dynabuf_t *retired;
+    size_t nretired;
+} ws_deque_t;
+
+/**
+ * Error codes for ws_deque operations
+ */
+typedef enum {
+    ALC_WS_DEQUE_SUCCESS = 0,
+    ALC_WS_DEQUE_NO_MEM = INT_MIN,
+    ALC_WS_DEQUE_INVALID,
+    ALC_WS_DEQUE_EMPTY,
+    // a steal lost a race with another thread, and may be retried
+    ALC_WS_DEQUE_ABORT
+} ws_deque_error_t;
+
+/*
+ * Constructor function for ws_deque type
+ * @param size the initial capacity, rounded up to a power of two.
+ * @return new deque, or NULL on errors.
+ */
+ws_deque_t *create_ws_deque(size_t size);
+
+/*
+ * Push an item onto the bottom of the deque.  Owner thread only.
+ * @param self the deque to push to
+ * @param item the item to push
+ * @return ws_deque_error_t error code
+ */
+int ws_deque_push(ws_deque_t *self, void *item);
+
+/*
+ * Pop the most recently pushed item from the bottom of the deque.  Owner
+ * thread only.
+ * @param self the deque to pop from
+ * @param out receives the item
+ * @return ws_deque_error_t error code, ALC_WS_DEQUE_EMPTY if there was
+ * nothing to pop.
+ */
+int ws_deque_pop(ws_deque_t *self, void **out);
+
+/*
+ * Steal the least recently pushed item from the top of the deque.  Any
+ * thread.
+ * @param self the deque to steal from
+ * @param out receives the item
+ * @return ws_deque_error_t error code, ALC_WS_DEQUE_EMPTY if there was
+ * nothing to steal, or ALC_WS_DEQUE_ABORT if another thread took the item
+ * first.
+ */
+int ws_deque_steal(ws_deque_t *self, void **out);
+
+/*
+ * Estimate the number of items in the deque.  The result is approximate
+ * while other threads are active.
+ * @param self the deque to use
+ * @return the number of items, -1 on error.
+ */
+int64_t ws_deque_size(ws_deque_t *self);
+
+/*
+ * Free the deque and every buffer it has used.  No thread may use it
+ * afterwards.
+ * @param self the deque to free
+ */
+void ws_deque_free(ws_deque_t *self);
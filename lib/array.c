@@ -3,12 +3,29 @@
 #include <alibc/containers/debug.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include "array_internal.h"
+
+/*
+ * File-backed arrays set aside one cache line at the start of their file for
+ * this header, which records what the file holds.
+ */
+#define ARRAY_FILE_MAGIC    0x796172612e636c61ULL // "alc.aray"
+#define ARRAY_FILE_HEADER   64
+typedef struct {
+    uint64_t magic;
+    uint64_t elem_size;
+    uint64_t size;
+} array_file_header;
 
 // private functions
+static void swap_elems(char *a, char *b, size_t unit);
+static void sync_header(array_t*);
 static int check_valid(array_t*);
-static int check_space_available(array_t*, int);
+static int check_space_available(array_t*, size_t);
+static int reserve(array_t*, size_t);
 
-array_t *create_array(int size, int unit) {
+array_t *create_array(size_t size, size_t unit) {
     array_t *r       = malloc(sizeof(array_t));
     if(r == NULL)   {
         DBG_LOG("Could not malloc array_t\n");
@@ -16,7 +33,29 @@ array_t *create_array(int size, int unit) {
     }
     r->data          = create_dynabuf(size, unit);
     if(r->data == NULL)  {
-        DBG_LOG("Could not create dynabuf with size %d\n", size);
+        DBG_LOG("Could not create dynabuf with size %zu\n", size);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+
+    r->size     = 0;
+    r->status   = ALC_ARRAY_SUCCESS;
+
+done:
+    return r;
+}
+
+
+array_t *create_array_reserved(size_t size, size_t unit, size_t max) {
+    array_t *r       = malloc(sizeof(array_t));
+    if(r == NULL)   {
+        DBG_LOG("Could not malloc array_t\n");
+        goto done;
+    }
+    r->data          = create_dynabuf_reserved(size, unit, max);
+    if(r->data == NULL)  {
+        DBG_LOG("Could not reserve dynabuf with size %zu\n", max);
         free(r);
         r = NULL;
         goto done;
@@ -30,7 +69,48 @@ done:
 }
 
 
-int array_insert(array_t *self, int where, void *item) {
+array_t *create_array_mmap(const char *path, size_t size, size_t unit) {
+    array_file_header *header;
+    array_t *r       = malloc(sizeof(array_t));
+    if(r == NULL)   {
+        DBG_LOG("Could not malloc array_t\n");
+        goto done;
+    }
+    r->data = create_dynabuf_mmap(path, size, unit, ARRAY_FILE_HEADER);
+    if(r->data == NULL)  {
+        DBG_LOG("Could not map dynabuf from %s\n", path);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+
+    header = dynabuf_header(r->data);
+    if(header->magic == ARRAY_FILE_MAGIC && header->elem_size == unit
+            && header->size <= r->data->capacity/unit) {
+        r->size = header->size;
+    }
+    else if(header->magic == 0) {
+        // new file
+        header->magic       = ARRAY_FILE_MAGIC;
+        header->elem_size   = unit;
+        header->size        = 0;
+        r->size             = 0;
+    }
+    else {
+        DBG_LOG("%s does not hold an array of unit size %zu\n", path, unit);
+        dynabuf_free(r->data);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->status   = ALC_ARRAY_SUCCESS;
+
+done:
+    return r;
+}
+
+
+int array_insert(array_t *self, size_t where, void *item) {
     int status = check_space_available(self, 1);
     switch(status) {
         case ALC_ARRAY_SUCCESS:
@@ -53,7 +133,9 @@ int array_insert(array_t *self, int where, void *item) {
 
         case ALC_ARRAY_NO_MEM:
             // try to allocate more space to store this item
-            status = array_resize(self, 2*self->size + 1);
+            status = array_resize(
+                self, dynabuf_grow_count(self->data, self->size + 1)
+            );
             if(status == ALC_ARRAY_SUCCESS) {
                 DBG_LOG("realloc successful pre-insertion\n");
                 status = array_insert(self, where, item);
@@ -75,7 +157,37 @@ invalid_status:
 }
 
 
-int array_insert_unsafe(array_t *self, int where, void *item) {
+int array_insert_ordered(array_t *self, size_t where, void *item) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("Array state was invalid on ordered insert operation\n");
+        goto invalid_status;
+    }
+    if(where > self->size) {
+        DBG_LOG("Attempted insert beyond end of array.\n");
+        status = ALC_ARRAY_IDX_OOB;
+        goto done;
+    }
+    status = reserve(self, 1);
+    if(status != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("No space to insert new item. Ignoring.\n");
+        goto done;
+    }
+    memmove(
+        dynabuf_at(self->data, where + 1),
+        dynabuf_at(self->data, where),
+        (self->size - where)*self->data->elem_size
+    );
+    dynabuf_set(self->data, where, item);
+    self->size++;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int array_insert_unsafe(array_t *self, size_t where, void *item) {
     int status = check_valid(self);
     if(status != ALC_ARRAY_SUCCESS) {
         DBG_LOG("Array was not valid on unsafe insert.\n");
@@ -105,7 +217,9 @@ int array_append(array_t *self, void *item) {
 
         case ALC_ARRAY_NO_MEM:
             DBG_LOG("realloc needed\n");
-            status = array_resize(self, 2*self->size + 1);
+            status = array_resize(
+                self, dynabuf_grow_count(self->data, self->size + 1)
+            );
             if(status == ALC_ARRAY_SUCCESS) {
                 status = array_append(self, item);
             }
@@ -124,7 +238,102 @@ invalid_status:
 }
 
 
-void **array_fetch(array_t *self, int which)    {
+int array_append_n(array_t *self, void *src, size_t count) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("Array state was invalid on append_n operation\n");
+        goto invalid_status;
+    }
+    if(src == NULL && count > 0) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    status = reserve(self, count);
+    if(status != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("No space to append %zu items.\n", count);
+        goto done;
+    }
+    memcpy(
+        dynabuf_at(self->data, self->size), src, count*self->data->elem_size
+    );
+    self->size += count;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int array_extend(array_t *self, array_t *other) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    if(check_valid(other) != ALC_ARRAY_SUCCESS
+            || other->data->elem_size != self->data->elem_size) {
+        DBG_LOG("Cannot extend array with invalid or mismatched array\n");
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    // reserve before taking the source pointer, other may be self.
+    size_t count = other->size;
+    status = reserve(self, count);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto done;
+    }
+    memcpy(
+        dynabuf_at(self->data, self->size),
+        dynabuf_at(other->data, 0),
+        count*self->data->elem_size
+    );
+    self->size += count;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int array_insert_range(array_t *self, size_t where, void *src, size_t count) {
+    int status = check_valid(self);
+    size_t displaced;
+    size_t unit;
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    if(where > self->size) {
+        DBG_LOG("Attempted insert beyond end of array.\n");
+        status = ALC_ARRAY_IDX_OOB;
+        goto done;
+    }
+    if(src == NULL && count > 0) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    status = reserve(self, count);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto done;
+    }
+
+    // move the objects occupying [where, where + count) into the part of the
+    // new tail which the inserted block does not cover.
+    unit = self->data->elem_size;
+    displaced = self->size - where < count ? self->size - where:count;
+    memcpy(
+        dynabuf_at(self->data, self->size + count - displaced),
+        dynabuf_at(self->data, where),
+        displaced*unit
+    );
+    memcpy(dynabuf_at(self->data, where), src, count*unit);
+    self->size += count;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+void **array_fetch(array_t *self, size_t which)    {
     void **r = NULL;
     int status = ALC_ARRAY_SUCCESS;
     if(check_valid(self) != ALC_ARRAY_SUCCESS) {
@@ -136,14 +345,14 @@ void **array_fetch(array_t *self, int which)    {
         status = ALC_ARRAY_IDX_OOB;
         goto done;
     }
-    if(which >= self->size || which < 0) {
-        DBG_LOG("Requested fetch index was out of bounds: %d\n", which);
+    if(which >= self->size) {
+        DBG_LOG("Requested fetch index was out of bounds: %zu\n", which);
         status = ALC_ARRAY_IDX_OOB;
         goto done;
     }
     else  {
-        self->status = ALC_ARRAY_SUCCESS;
-        r = dynabuf_fetch(self->data, which);
+        // self and the index were validated above
+        r = array_at_unchecked(self, which);
     }
 done:
     self->status = status;
@@ -152,7 +361,7 @@ invalid_status:
 }
 
 
-int array_resize(array_t *self, int count) {
+int array_resize(array_t *self, size_t count) {
     int status = check_valid(self);
     if(status != ALC_ARRAY_SUCCESS) {
         goto invalid_status;
@@ -161,7 +370,7 @@ int array_resize(array_t *self, int count) {
     if(count == self->size) {
         goto done;
     }
-    if(count*self->data->elem_size > self->data->capacity) {
+    if(count > self->data->capacity/self->data->elem_size) {
         if(dynabuf_resize(self->data, count) != ALC_DYNABUF_SUCCESS) {
             DBG_LOG("Could not resize array backing buffer.\n");
             status = ALC_ARRAY_NO_MEM;
@@ -169,7 +378,7 @@ int array_resize(array_t *self, int count) {
         }
     }
     else {
-        DBG_LOG("Requested array count %d was too small\n", count);
+        DBG_LOG("Requested array count %zu was too small\n", count);
         status = ALC_ARRAY_IDX_OOB;
         goto done;
     }
@@ -181,7 +390,7 @@ invalid_status:
 }
 
 
-void **array_remove(array_t *self, int which)  {
+void **array_remove(array_t *self, size_t which)  {
     void **r = NULL;
     int status = check_valid(self);
     if(status != ALC_ARRAY_SUCCESS) {
@@ -194,7 +403,7 @@ void **array_remove(array_t *self, int which)  {
         goto done;
     }
     if(which >= self->size)  {
-        DBG_LOG("Requested remove index was out of bounds: %d\n",
+        DBG_LOG("Requested remove index was out of bounds: %zu\n",
                 which);
         status = ALC_ARRAY_IDX_OOB;
         goto done;
@@ -212,37 +421,86 @@ invalid_status:
     return r;
 }
 
-int array_swap(array_t *self, int first, int second) {
+int array_erase_range(array_t *self, size_t begin, size_t count) {
     int status = check_valid(self);
     if(status != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("self was invalid on erase operation.\n");
         goto invalid_status;
     }
-    // > instead of >= to allow swapping in a NULL without append...
-    if(first > self->size || second > self->size) {
+    if(begin > self->size || count > self->size - begin) {
+        DBG_LOG("Requested erase range was out of bounds: %zu+%zu\n",
+                begin, count);
         status = ALC_ARRAY_IDX_OOB;
         goto done;
     }
-    // due to larger-than-register sizes, we cannot simply swap values,
-    // a true memory-to-memory copy may be needed (rats)
-    if(self->data->elem_size <= sizeof(void*)) {
-        void *tmp_first = *dynabuf_fetch(self->data, first);
-        void *tmp_second = *dynabuf_fetch(self->data, second);
-        dynabuf_set(self->data, first, tmp_second);
-        dynabuf_set(self->data, second, tmp_first);
-        status = ALC_ARRAY_SUCCESS;
+    memmove(
+        dynabuf_at(self->data, begin),
+        dynabuf_at(self->data, begin + count),
+        (self->size - begin - count)*self->data->elem_size
+    );
+    self->size -= count;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int64_t array_remove_if(array_t *self, array_pred_type *pred, void *arg) {
+    int64_t r;
+    size_t read;
+    size_t run = 0;
+    size_t write = 0;
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        r = status;
+        goto invalid_status;
     }
-    else {
-        char *cpy_buf = malloc(self->data->elem_size);
-        if(cpy_buf == NULL) {
-            status = ALC_ARRAY_NO_MEM;
-            goto done;
+    if(pred == NULL) {
+        status = ALC_ARRAY_INVALID;
+        r = status;
+        goto done;
+    }
+    // compact runs of kept items with one block move per run.  A removed
+    // item, or the end of the array, closes the current run.
+    for(read = 0; read <= self->size; read++) {
+        if(read < self->size && !pred(dynabuf_at(self->data, read), arg)) {
+            continue;
         }
-        memcpy(
-            cpy_buf, dynabuf_fetch(self->data, first), self->data->elem_size
+        if(run != write) {
+            memmove(
+                dynabuf_at(self->data, write),
+                dynabuf_at(self->data, run),
+                (read - run)*self->data->elem_size
+            );
+        }
+        write += read - run;
+        run = read + 1;
+    }
+    r = self->size - write;
+    self->size = write;
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+int array_swap(array_t *self, size_t first, size_t second) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    // > instead of >= to allow swapping in a NULL without append...
+    if(first > self->size || second > self->size) {
+        status = ALC_ARRAY_IDX_OOB;
+        goto done;
+    }
+    if(first != second) {
+        swap_elems(
+            (char*)dynabuf_at(self->data, first),
+            (char*)dynabuf_at(self->data, second),
+            self->data->elem_size
         );
-        dynabuf_set(self->data, first, dynabuf_fetch(self->data, second));
-        dynabuf_set(self->data, second, cpy_buf);
-        free(cpy_buf);
     }
 
 done:
@@ -251,8 +509,8 @@ invalid_status:
     return status;
 }
 
-int array_size(array_t *self) {
-    int size = -1;
+int64_t array_size(array_t *self) {
+    int64_t size = -1;
     if(check_valid(self) == ALC_ARRAY_SUCCESS)   {
         self->status = ALC_ARRAY_SUCCESS;
         size = self->size;
@@ -260,6 +518,35 @@ int array_size(array_t *self) {
     return size;
 }
 
+int array_set_growth(array_t *self, int policy) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    if(dynabuf_set_growth(self->data, policy) != ALC_DYNABUF_SUCCESS) {
+        DBG_LOG("Could not set growth policy %d\n", policy);
+        status = ALC_ARRAY_INVALID;
+    }
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+int array_flush(array_t *self) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    sync_header(self);
+    if(dynabuf_flush(self->data) != ALC_DYNABUF_SUCCESS) {
+        DBG_LOG("Could not flush array backing buffer.\n");
+        status = ALC_ARRAY_FAILURE;
+    }
+    self->status = status;
+invalid_status:
+    return status;
+}
+
 void array_free(array_t *self)    {
     if(self == NULL)    {
         DBG_LOG("self was null\n");
@@ -269,6 +556,7 @@ void array_free(array_t *self)    {
         free(self);
     }
     else {
+        sync_header(self);
         dynabuf_free(self->data);
         free(self);
     }
@@ -282,6 +570,31 @@ inline int array_status(array_t *self)    {
  *Helper functions
  */
 
+/*
+ * Common element sizes get a copy of swap_chunks with a constant size, which
+ * the compiler turns into a few register or vector moves.
+ */
+static void swap_elems(char *a, char *b, size_t unit) {
+    switch(unit) {
+        case 1:     swap_chunks(a, b, 1);       break;
+        case 2:     swap_chunks(a, b, 2);       break;
+        case 4:     swap_chunks(a, b, 4);       break;
+        case 8:     swap_chunks(a, b, 8);       break;
+        case 16:    swap_chunks(a, b, 16);      break;
+        case 32:    swap_chunks(a, b, 32);      break;
+        case 64:    swap_chunks(a, b, 64);      break;
+        default:    swap_chunks(a, b, unit);    break;
+    }
+}
+
+// record the element count of file-backed arrays in their file.
+static void sync_header(array_t *self) {
+    if(self->data->mode == ALC_DYNABUF_MAPPED && self->data->buf != NULL) {
+        array_file_header *header = dynabuf_header(self->data);
+        header->size = self->size;
+    }
+}
+
 static int check_valid(array_t *self)    {
     int status = ALC_ARRAY_SUCCESS;
     if(self == NULL)    {
@@ -297,7 +610,31 @@ done:
 }
 
 // size in elements, not bytes
-static int check_space_available(array_t *self, int elements)  {
+// grows the array according to its growth policy if count elements do not fit
+static int reserve(array_t *self, size_t count) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto done;
+    }
+    // the new size must still be representable in bytes
+    size_t unit = self->data->elem_size;
+    if(count > SIZE_MAX - self->size
+            || (unit != 0 && self->size + count > SIZE_MAX/unit)) {
+        status = ALC_ARRAY_NO_MEM;
+        goto done;
+    }
+    status = check_space_available(self, count);
+    if(status == ALC_ARRAY_NO_MEM) {
+        status = array_resize(
+            self, dynabuf_grow_count(self->data, self->size + count)
+        );
+    }
+done:
+    return status;
+}
+
+// size in elements, not bytes
+static int check_space_available(array_t *self, size_t elements)  {
     int status = check_valid(self);
     if(status == ALC_ARRAY_SUCCESS) {
         if(self->size + elements > self->data->capacity/self->data->elem_size) {
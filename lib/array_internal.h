@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Helpers shared by the array translation units.  Not installed.
+ */
+
+#if defined(__GNUC__)
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+// elements are swapped through a stack buffer of this size
+#define SWAP_CHUNK 64
+
+/*
+ * Swap unit bytes between a and b through a stack buffer, a chunk at a time.
+ * Inlined with a constant unit, this becomes a few register or vector moves.
+ */
+static ALWAYS_INLINE void swap_chunks(char *a, char *b, size_t unit) {
+    char tmp[SWAP_CHUNK];
+    for(size_t off = 0; off < unit; off += SWAP_CHUNK) {
+        size_t len = (unit - off < SWAP_CHUNK) ? unit - off:SWAP_CHUNK;
+        memcpy(tmp, a + off, len);
+        memcpy(a + off, b + off, len);
+        memcpy(b + off, tmp, len);
+    }
+}
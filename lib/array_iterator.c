@@ -2,18 +2,20 @@
 #include <alibc/containers/array.h>
 #include <stdlib.h>
 
-static void *array_iter_next(iter_context *ctx) {
-    void *r = NULL;
+static void **array_iter_next(iter_context *ctx) {
+    void **r = NULL;
     array_t *target = (array_t*)ctx->_data;
-    if(target == NULL) {
+    int64_t size = array_size(target);
+    if(target == NULL || size < 0) {
         ctx->status = ALC_ITER_INVALID;
         goto done;
     }
-    if(ctx->index < array_size(target)) {
-        r = array_fetch(target, ctx->index);
+    size_t end = iter_end(ctx, size);
+    if(ctx->index < end) {
+        r = array_at_unchecked(target, ctx->index);
         ctx->index++;
     }
-    if(ctx->index == array_size(target) || array_size(target) == 0) {
+    if(ctx->index >= end) {
         ctx->status = ALC_ITER_STOP;
     }
     else {
@@ -23,19 +25,69 @@ done:
     return r;
 }
 
+static int array_iter_batch(iter_context *ctx, void **out, int n) {
+    int count = 0;
+    array_t *target = (array_t*)ctx->_data;
+    int64_t size = array_size(target);
+    if(target == NULL || size < 0) {
+        ctx->status = ALC_ITER_INVALID;
+        count = -1;
+        goto done;
+    }
+    size_t end = iter_end(ctx, size);
+    if(ctx->index + n < end) {
+        end = ctx->index + n;
+    }
+    for(size_t i = ctx->index; i < end; i++) {
+        out[count++] = array_at_unchecked(target, i);
+    }
+    if(ctx->index < end) {
+        ctx->index = end;
+    }
+    ctx->status = (ctx->index >= iter_end(ctx, size)) ?
+        ALC_ITER_STOP:ALC_ITER_CONTINUE;
+done:
+    return count;
+}
+
+static size_t array_iter_limit(iter_context *ctx) {
+    int64_t size = array_size((array_t*)ctx->_data);
+    return (size < 0) ? 0:size;
+}
+
 iter_context *create_array_iterator(array_t *target) {
+    return create_array_iterator_range(target, 0, ALC_ITER_END);
+}
+
+iter_context *create_array_iterator_range(array_t *target, size_t begin,
+        size_t end) {
     iter_context *r = NULL;
-    if(target == NULL) {
+    if(target == NULL || begin > end) {
         goto done;
     }
     r = malloc(sizeof(iter_context));
     if(r == NULL) {
         goto done;
     }
-    r->index = 0;
-    r->status = ALC_ITER_READY;
-    r->_data = target;
-    r->next = array_iter_next;
+    iter_init_array(r, target);
+    r->flags &= ~ALC_ITER_STATIC;
+    r->index = begin;
+    r->end = end;
 done:
     return r;
 }
+
+int iter_init_array(iter_context *ctx, array_t *target) {
+    if(ctx == NULL) {
+        return ALC_ITER_NULL;
+    }
+    ctx->index = 0;
+    ctx->end = ALC_ITER_END;
+    ctx->status = ALC_ITER_READY;
+    ctx->flags = ALC_ITER_STATIC;
+    ctx->_data = target;
+    ctx->next = array_iter_next;
+    ctx->next_batch = array_iter_batch;
+    ctx->limit = array_iter_limit;
+    return (target == NULL) ? ALC_ITER_INVALID:ALC_ITER_READY;
+}
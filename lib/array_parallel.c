@@ -0,0 +1,358 @@
+#include <alibc/containers/array_parallel.h>
+#include <alibc/containers/array_sort.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Shared state of a parallel loop or reduction.  The array is split into
+ * ranges pieces of near-equal size, one task each.
+ */
+typedef struct {
+    array_t             *self;
+    size_t              size;
+    size_t              ranges;
+    array_range_fn      *fn;
+    array_reduce_fn     *reduce;
+    char                *partials;
+    size_t              result_size;
+    void                *arg;
+} range_job;
+
+/*
+ * One slice of a pairwise merge: merges the outputs [k0, k1) of the runs
+ * src[a, a + la) and src[b, b + lb) into dst[a + k0, a + k1).  b is always
+ * a + la.
+ */
+typedef struct {
+    size_t a;
+    size_t la;
+    size_t lb;
+    size_t k0;
+    size_t k1;
+} merge_slice;
+
+typedef struct {
+    array_t     *self;
+    char        *src;
+    char        *dst;
+    size_t      unit;
+    size_t      *bounds;
+    merge_slice *slices;
+    cmp_type    *cmp;
+} sort_job;
+
+// private functions
+static size_t range_count(size_t size, thread_pool_t *pool);
+static size_t range_begin(size_t size, size_t ranges, size_t which);
+static void for_task(void *arg, size_t task);
+static void reduce_task(void *arg, size_t task);
+static void sort_task(void *arg, size_t task);
+static void merge_task(void *arg, size_t task);
+static size_t corank(char *a, size_t la, char *b, size_t lb, size_t k,
+        size_t unit, cmp_type *cmp);
+
+
+int array_parallel_for(array_t *self, thread_pool_t *pool, array_range_fn *fn,
+        void *arg) {
+    range_job job;
+    int status = ALC_ARRAY_SUCCESS;
+    if(array_size(self) < 0) {
+        DBG_LOG("Array state was invalid on parallel for operation\n");
+        status = ALC_ARRAY_INVALID;
+        goto invalid_status;
+    }
+    if(thread_pool_size(pool) < 1 || fn == NULL) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    job.self    = self;
+    job.size    = self->size;
+    job.ranges  = range_count(self->size, pool);
+    job.fn      = fn;
+    job.arg     = arg;
+    if(thread_pool_run(pool, for_task, &job, job.ranges)
+            != ALC_THREAD_POOL_SUCCESS) {
+        status = ALC_ARRAY_FAILURE;
+    }
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int array_parallel_reduce(array_t *self, thread_pool_t *pool,
+        array_reduce_fn *fn, array_combine_fn *combine, void *result,
+        size_t result_size, void *arg) {
+    range_job job;
+    int status = ALC_ARRAY_SUCCESS;
+    job.partials = NULL;
+    if(array_size(self) < 0) {
+        DBG_LOG("Array state was invalid on parallel reduce operation\n");
+        status = ALC_ARRAY_INVALID;
+        goto invalid_status;
+    }
+    if(thread_pool_size(pool) < 1 || fn == NULL || combine == NULL
+            || result == NULL || result_size == 0) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    job.self        = self;
+    job.size        = self->size;
+    job.ranges      = range_count(self->size, pool);
+    job.reduce      = fn;
+    job.result_size = result_size;
+    job.arg         = arg;
+    if(job.ranges > SIZE_MAX / result_size) {
+        status = ALC_ARRAY_NO_MEM;
+        goto done;
+    }
+    job.partials = malloc(job.ranges*result_size);
+    if(job.partials == NULL) {
+        DBG_LOG("Could not allocate partial results for reduce\n");
+        status = ALC_ARRAY_NO_MEM;
+        goto done;
+    }
+    // every range starts from the identity
+    for(size_t i = 0; i < job.ranges; i++) {
+        memcpy(job.partials + i*result_size, result, result_size);
+    }
+    if(thread_pool_run(pool, reduce_task, &job, job.ranges)
+            != ALC_THREAD_POOL_SUCCESS) {
+        status = ALC_ARRAY_FAILURE;
+        goto done;
+    }
+    for(size_t i = 0; i < job.ranges; i++) {
+        combine(result, job.partials + i*result_size, arg);
+    }
+done:
+    free(job.partials);
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int array_parallel_sort(array_t *self, thread_pool_t *pool, cmp_type *cmp) {
+    sort_job job;
+    size_t runs;
+    size_t threads;
+    char *scratch = NULL;
+    int status = ALC_ARRAY_SUCCESS;
+    job.bounds = NULL;
+    job.slices = NULL;
+    if(array_size(self) < 0) {
+        DBG_LOG("Array state was invalid on parallel sort operation\n");
+        status = ALC_ARRAY_INVALID;
+        goto invalid_status;
+    }
+    if(thread_pool_size(pool) < 1 || cmp == NULL) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+
+    // one sorted run per thread, unless the array is too small to split
+    threads = thread_pool_size(pool);
+    runs = self->size / ALC_ARRAY_PARALLEL_GRAIN;
+    runs = (runs < threads) ? runs:threads;
+    if(runs < 2) {
+        status = array_sort(self, cmp);
+        goto done;
+    }
+
+    job.self    = self;
+    job.unit    = self->data->elem_size;
+    job.cmp     = cmp;
+    job.bounds  = malloc((runs + 1)*sizeof(size_t));
+    // a round splits its merges into at most 2*threads slices, plus one
+    // for an unpaired run
+    job.slices  = malloc((2*threads + 1)*sizeof(merge_slice));
+    scratch     = malloc(self->size*job.unit);
+    if(job.bounds == NULL || job.slices == NULL || scratch == NULL) {
+        DBG_LOG("Could not allocate parallel sort scratch space\n");
+        status = ALC_ARRAY_NO_MEM;
+        goto done;
+    }
+    for(size_t i = 0; i <= runs; i++) {
+        job.bounds[i] = range_begin(self->size, runs, i);
+    }
+    if(thread_pool_run(pool, sort_task, &job, runs)
+            != ALC_THREAD_POOL_SUCCESS) {
+        status = ALC_ARRAY_FAILURE;
+        goto done;
+    }
+
+    job.src = array_data(self);
+    job.dst = scratch;
+    while(runs > 1) {
+        size_t pairs = runs / 2;
+        size_t nslices = 0;
+        size_t parts = 2*threads / pairs;
+        char *tmp;
+        for(size_t p = 0; p < pairs; p++) {
+            merge_slice pair;
+            size_t total;
+            size_t n;
+            pair.a  = job.bounds[2*p];
+            pair.la = job.bounds[2*p + 1] - pair.a;
+            pair.lb = job.bounds[2*p + 2] - job.bounds[2*p + 1];
+            total = pair.la + pair.lb;
+            // slices smaller than the grain are not worth a task
+            n = total / ALC_ARRAY_PARALLEL_GRAIN;
+            n = (n < 1) ? 1:(n > parts) ? parts:n;
+            for(size_t s = 0; s < n; s++) {
+                job.slices[nslices] = pair;
+                job.slices[nslices].k0 = range_begin(total, n, s);
+                job.slices[nslices].k1 = range_begin(total, n, s + 1);
+                nslices++;
+            }
+        }
+        if(runs % 2) {
+            // the unpaired last run is copied across as-is
+            job.slices[nslices].a   = job.bounds[runs - 1];
+            job.slices[nslices].la  = job.bounds[runs] - job.bounds[runs - 1];
+            job.slices[nslices].lb  = 0;
+            job.slices[nslices].k0  = 0;
+            job.slices[nslices].k1  = job.slices[nslices].la;
+            nslices++;
+        }
+        if(thread_pool_run(pool, merge_task, &job, nslices)
+                != ALC_THREAD_POOL_SUCCESS) {
+            status = ALC_ARRAY_FAILURE;
+            goto done;
+        }
+        for(size_t i = 0; 2*i < runs; i++) {
+            job.bounds[i] = job.bounds[2*i];
+        }
+        runs = (runs + 1) / 2;
+        job.bounds[runs] = self->size;
+        tmp = job.src;
+        job.src = job.dst;
+        job.dst = tmp;
+    }
+    if(job.src != (char*)array_data(self)) {
+        memcpy(array_data(self), job.src, self->size*job.unit);
+    }
+done:
+    free(scratch);
+    free(job.bounds);
+    free(job.slices);
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+/*
+ * Helper functions
+ */
+
+// a few ranges per thread evens out uneven per-element costs
+static size_t range_count(size_t size, thread_pool_t *pool) {
+    size_t ranges = (size + ALC_ARRAY_PARALLEL_GRAIN - 1)
+        / ALC_ARRAY_PARALLEL_GRAIN;
+    size_t limit = 4*(size_t)thread_pool_size(pool);
+    return (ranges < 1) ? 1:(ranges > limit) ? limit:ranges;
+}
+
+static size_t range_begin(size_t size, size_t ranges, size_t which) {
+    size_t rem = size % ranges;
+    return (size / ranges)*which + ((which < rem) ? which:rem);
+}
+
+static void for_task(void *arg, size_t task) {
+    range_job *job = arg;
+    size_t begin = range_begin(job->size, job->ranges, task);
+    size_t end = range_begin(job->size, job->ranges, task + 1);
+    if(begin < end) {
+        job->fn(job->self, begin, end, job->arg);
+    }
+}
+
+static void reduce_task(void *arg, size_t task) {
+    range_job *job = arg;
+    size_t begin = range_begin(job->size, job->ranges, task);
+    size_t end = range_begin(job->size, job->ranges, task + 1);
+    if(begin < end) {
+        job->reduce(job->self, begin, end,
+                job->partials + task*job->result_size, job->arg);
+    }
+}
+
+// sorts one run through a private view of the array, so that concurrent
+// sorts do not share the status field.
+static void sort_task(void *arg, size_t task) {
+    sort_job *job = arg;
+    dynabuf_t data = *job->self->data;
+    array_t view;
+    size_t begin = job->bounds[task];
+    data.buf        += begin*job->unit;
+    data.capacity   = (job->bounds[task + 1] - begin)*job->unit;
+    view.data       = &data;
+    view.size       = job->bounds[task + 1] - begin;
+    view.status     = ALC_ARRAY_SUCCESS;
+    array_sort(&view, job->cmp);
+}
+
+static inline void *load(char *elem, size_t unit) {
+    uintptr_t value = 0;
+    if(unit > sizeof(void*)) {
+        return elem;
+    }
+    memcpy(&value, elem, unit);
+    return (void*)value;
+}
+
+/*
+ * Find how many of the first k merged outputs come from a, for a stable merge
+ * which takes from a on ties.
+ */
+static size_t corank(char *a, size_t la, char *b, size_t lb, size_t k,
+        size_t unit, cmp_type *cmp) {
+    size_t lo = (k > lb) ? k - lb:0;
+    size_t hi = (k < la) ? k:la;
+    while(lo < hi) {
+        size_t i = lo + (hi - lo)/2;
+        size_t j = k - i;
+        // a[i] must come before b[j - 1] unless b[j - 1] is strictly smaller
+        if(j > 0 && cmp(load(b + (j - 1)*unit, unit),
+                    load(a + i*unit, unit)) >= 0) {
+            lo = i + 1;
+        }
+        else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+static void merge_task(void *arg, size_t task) {
+    sort_job *job = arg;
+    merge_slice *slice = &job->slices[task];
+    size_t unit = job->unit;
+    char *a = job->src + slice->a*unit;
+    char *b = a + slice->la*unit;
+    char *out = job->dst + (slice->a + slice->k0)*unit;
+    size_t i = corank(a, slice->la, b, slice->lb, slice->k0, unit, job->cmp);
+    size_t j = slice->k0 - i;
+    size_t i_end = corank(a, slice->la, b, slice->lb, slice->k1, unit,
+            job->cmp);
+    size_t j_end = slice->k1 - i_end;
+    while(i < i_end && j < j_end) {
+        char *next;
+        if(job->cmp(load(b + j*unit, unit), load(a + i*unit, unit)) < 0) {
+            next = b + (j++)*unit;
+        }
+        else {
+            next = a + (i++)*unit;
+        }
+        memcpy(out, next, unit);
+        out += unit;
+    }
+    memcpy(out, a + i*unit, (i_end - i)*unit);
+    out += (i_end - i)*unit;
+    memcpy(out, b + j*unit, (j_end - j)*unit);
+}
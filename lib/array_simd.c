@@ -0,0 +1,281 @@
+#include <alibc/containers/array_simd.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/debug.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "array_internal.h"
+
+/*
+ * The kernels are plain loops written so that the compiler can vectorize
+ * them.  They are force-inlined into one wrapper per instruction set, each
+ * built with a different target attribute, and dispatch picks a wrapper with
+ * __builtin_cpu_supports.  meson.build compiles this file with
+ * -ftree-vectorize, so that the loops are vectorized at -O2 as well.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALC_SIMD_X86 1
+#endif
+
+// find scans this many elements branch-free between early-exit checks
+#define FIND_BLOCK 64
+
+typedef enum {
+    OP_FIND,
+    OP_COUNT,
+    OP_MIN,
+    OP_MAX,
+    OP_SUM
+} kernel_op;
+
+/*
+ * One kernel per element type.  Results are returned as uint64_t: an index
+ * for OP_FIND, a count for OP_COUNT, and the value widened through WIDE for
+ * the others.
+ */
+#define DEFINE_KERNEL(name, T, WIDE)                                        \
+static ALWAYS_INLINE uint64_t name(const T *p, size_t n, kernel_op op,      \
+        T v) {                                                              \
+    uint64_t acc = 0;                                                       \
+    T best = (n > 0) ? p[0]:0;                                              \
+    switch(op) {                                                            \
+        case OP_FIND:                                                       \
+            for(size_t i = 0; i < n; i += FIND_BLOCK) {                     \
+                size_t len = (n - i < FIND_BLOCK) ? n - i:FIND_BLOCK;       \
+                int any = 0;                                                \
+                for(size_t j = 0; j < len; j++) {                           \
+                    any |= (p[i + j] == v);                                 \
+                }                                                           \
+                if(any) {                                                   \
+                    while(p[i] != v) {                                      \
+                        i++;                                                \
+                    }                                                       \
+                    return i;                                               \
+                }                                                           \
+            }                                                               \
+            return n;                                                       \
+        case OP_COUNT:                                                      \
+            for(size_t i = 0; i < n; i++) {                                 \
+                acc += (p[i] == v);                                         \
+            }                                                               \
+            return acc;                                                     \
+        case OP_MIN:                                                        \
+            for(size_t i = 1; i < n; i++) {                                 \
+                best = (p[i] < best) ? p[i]:best;                           \
+            }                                                               \
+            return (uint64_t)(WIDE)best;                                    \
+        case OP_MAX:                                                        \
+            for(size_t i = 1; i < n; i++) {                                 \
+                best = (p[i] > best) ? p[i]:best;                           \
+            }                                                               \
+            return (uint64_t)(WIDE)best;                                    \
+        default:                                                            \
+            for(size_t i = 0; i < n; i++) {                                 \
+                acc += (uint64_t)(WIDE)p[i];                                \
+            }                                                               \
+            return acc;                                                     \
+    }                                                                       \
+}
+
+DEFINE_KERNEL(kernel_i8, int8_t, int64_t)
+DEFINE_KERNEL(kernel_u8, uint8_t, uint64_t)
+DEFINE_KERNEL(kernel_i16, int16_t, int64_t)
+DEFINE_KERNEL(kernel_u16, uint16_t, uint64_t)
+DEFINE_KERNEL(kernel_i32, int32_t, int64_t)
+DEFINE_KERNEL(kernel_u32, uint32_t, uint64_t)
+DEFINE_KERNEL(kernel_i64, int64_t, int64_t)
+DEFINE_KERNEL(kernel_u64, uint64_t, uint64_t)
+
+static ALWAYS_INLINE uint64_t kernel(const void *buf, size_t n, size_t unit,
+        bool is_signed, kernel_op op, int64_t v) {
+    switch(unit) {
+        case 1:
+            return is_signed ? kernel_i8(buf, n, op, (int8_t)v)
+                :kernel_u8(buf, n, op, (uint8_t)v);
+        case 2:
+            return is_signed ? kernel_i16(buf, n, op, (int16_t)v)
+                :kernel_u16(buf, n, op, (uint16_t)v);
+        case 4:
+            return is_signed ? kernel_i32(buf, n, op, (int32_t)v)
+                :kernel_u32(buf, n, op, (uint32_t)v);
+        default:
+            return is_signed ? kernel_i64(buf, n, op, v)
+                :kernel_u64(buf, n, op, (uint64_t)v);
+    }
+}
+
+#ifdef ALC_SIMD_X86
+__attribute__((target("avx2")))
+static uint64_t kernel_avx2(const void *buf, size_t n, size_t unit,
+        bool is_signed, kernel_op op, int64_t v) {
+    return kernel(buf, n, unit, is_signed, op, v);
+}
+
+__attribute__((target("sse4.1")))
+static uint64_t kernel_sse41(const void *buf, size_t n, size_t unit,
+        bool is_signed, kernel_op op, int64_t v) {
+    return kernel(buf, n, unit, is_signed, op, v);
+}
+#endif
+
+static uint64_t kernel_base(const void *buf, size_t n, size_t unit,
+        bool is_signed, kernel_op op, int64_t v) {
+    return kernel(buf, n, unit, is_signed, op, v);
+}
+
+// private functions
+static int check_valid(array_t *self);
+static int check_int_array(array_t *self, size_t unit);
+static uint64_t dispatch(array_t *self, bool is_signed, kernel_op op,
+        int64_t v);
+static int extremum(array_t *self, bool is_signed, kernel_op op,
+        int64_t *out);
+
+
+int64_t array_find_i32(array_t *self, int32_t value) {
+    int64_t r = ALC_ARRAY_INVALID;
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    status = check_int_array(self, sizeof(int32_t));
+    if(status != ALC_ARRAY_SUCCESS) {
+        r = status;
+        goto done;
+    }
+    r = dispatch(self, true, OP_FIND, value);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int64_t array_find_i64(array_t *self, int64_t value) {
+    int64_t r = ALC_ARRAY_INVALID;
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    status = check_int_array(self, sizeof(int64_t));
+    if(status != ALC_ARRAY_SUCCESS) {
+        r = status;
+        goto done;
+    }
+    r = dispatch(self, true, OP_FIND, value);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int64_t array_count_eq(array_t *self, int64_t value) {
+    int64_t r = ALC_ARRAY_INVALID;
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    status = check_int_array(self, 0);
+    if(status != ALC_ARRAY_SUCCESS) {
+        r = status;
+        goto done;
+    }
+    // equality does not depend on signedness
+    r = dispatch(self, false, OP_COUNT, value);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int array_min(array_t *self, bool is_signed, int64_t *out) {
+    return extremum(self, is_signed, OP_MIN, out);
+}
+
+
+int array_max(array_t *self, bool is_signed, int64_t *out) {
+    return extremum(self, is_signed, OP_MAX, out);
+}
+
+
+int array_sum(array_t *self, bool is_signed, int64_t *out) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    status = check_int_array(self, 0);
+    if(status != ALC_ARRAY_SUCCESS || out == NULL) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    *out = (int64_t)dispatch(self, is_signed, OP_SUM, 0);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(array_t *self) {
+    int status = ALC_ARRAY_SUCCESS;
+    if(array_size(self) < 0) {
+        DBG_LOG("Array state was invalid on vector operation\n");
+        status = ALC_ARRAY_INVALID;
+    }
+    return status;
+}
+
+// unit 0 accepts any supported integer size, self must be valid
+static int check_int_array(array_t *self, size_t unit) {
+    int status = ALC_ARRAY_SUCCESS;
+    size_t size = self->data->elem_size;
+    if((unit != 0 && size != unit)
+            || (size != 1 && size != 2 && size != 4 && size != 8)) {
+        DBG_LOG("Vector operations do not support elements of %zu bytes\n",
+                size);
+        status = ALC_ARRAY_INVALID;
+    }
+    return status;
+}
+
+static uint64_t dispatch(array_t *self, bool is_signed, kernel_op op,
+        int64_t v) {
+    const void *buf = array_data(self);
+    size_t unit = self->data->elem_size;
+#ifdef ALC_SIMD_X86
+    if(__builtin_cpu_supports("avx2")) {
+        return kernel_avx2(buf, self->size, unit, is_signed, op, v);
+    }
+    if(__builtin_cpu_supports("sse4.1")) {
+        return kernel_sse41(buf, self->size, unit, is_signed, op, v);
+    }
+#endif
+    return kernel_base(buf, self->size, unit, is_signed, op, v);
+}
+
+static int extremum(array_t *self, bool is_signed, kernel_op op,
+        int64_t *out) {
+    int status = check_valid(self);
+    if(status != ALC_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    status = check_int_array(self, 0);
+    if(status != ALC_ARRAY_SUCCESS || out == NULL) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    if(self->size == 0) {
+        status = ALC_ARRAY_IDX_OOB;
+        goto done;
+    }
+    *out = (int64_t)dispatch(self, is_signed, op, 0);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
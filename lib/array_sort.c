@@ -0,0 +1,423 @@
+#include <alibc/containers/array_sort.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "array_internal.h"
+
+/*
+ * The sort bodies below are written once against a runtime element size, and
+ * are force-inlined into wrappers which pass a constant size, so that loads,
+ * compares and swaps of 1, 2, 4 and 8 byte elements become plain register
+ * moves instead of generic memcpy calls.
+ */
+
+// ranges this short are finished with insertion sort
+#define SORT_CUTOFF 16
+
+typedef void (sort_fn)(char *base, size_t n, size_t unit, cmp_type *cmp,
+        int depth);
+
+// private functions
+static sort_fn sort_1;
+static sort_fn sort_2;
+static sort_fn sort_4;
+static sort_fn sort_8;
+static sort_fn sort_n;
+static int64_t bound(array_t *self, void *key, cmp_type *cmp, int8_t below);
+
+
+int array_sort(array_t *self, cmp_type *cmp) {
+    int64_t size = array_size(self);
+    return array_sort_range(self, 0, size < 0 ? 0:size, cmp);
+}
+
+
+int array_sort_range(array_t *self, size_t begin, size_t count,
+        cmp_type *cmp) {
+    int64_t size = array_size(self);
+    int status = ALC_ARRAY_SUCCESS;
+    int depth = 0;
+    size_t unit;
+    char *base;
+    if(size < 0) {
+        DBG_LOG("Array state was invalid on sort operation\n");
+        status = ALC_ARRAY_INVALID;
+        goto invalid_status;
+    }
+    if(cmp == NULL) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    if(begin > (size_t)size || count > (size_t)size - begin) {
+        DBG_LOG("Requested sort range was out of bounds: %zu+%zu\n",
+                begin, count);
+        status = ALC_ARRAY_IDX_OOB;
+        goto done;
+    }
+    // allow 2*log2(n) levels of quicksort before falling back to heapsort
+    for(size_t i = count; i > 1; i >>= 1) {
+        depth += 2;
+    }
+    unit = self->data->elem_size;
+    base = (char*)array_data(self) + begin*unit;
+    switch(unit) {
+        case 1:
+            sort_1(base, count, 1, cmp, depth);
+        break;
+
+        case 2:
+            sort_2(base, count, 2, cmp, depth);
+        break;
+
+        case 4:
+            sort_4(base, count, 4, cmp, depth);
+        break;
+
+        case 8:
+            sort_8(base, count, 8, cmp, depth);
+        break;
+
+        default:
+            sort_n(base, count, unit, cmp, depth);
+        break;
+    }
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+/*
+ * Element access helpers
+ */
+
+static ALWAYS_INLINE void *load(char *elem, size_t unit) {
+    uintptr_t value = 0;
+    if(unit > sizeof(void*)) {
+        return elem;
+    }
+    memcpy(&value, elem, unit);
+    return (void*)value;
+}
+
+#define at(base, idx, unit) ((base) + (idx)*(unit))
+
+/*
+ * Introsort
+ */
+
+static ALWAYS_INLINE void insertion_sort(char *base, size_t n, size_t unit,
+        cmp_type *cmp) {
+    for(size_t i = 1; i < n; i++) {
+        for(size_t j = i; j > 0; j--) {
+            char *cur = at(base, j, unit);
+            char *prev = cur - unit;
+            if(cmp(load(cur, unit), load(prev, unit)) >= 0) {
+                break;
+            }
+            swap_chunks(cur, prev, unit);
+        }
+    }
+}
+
+static ALWAYS_INLINE void sift_down(char *base, size_t root, size_t n,
+        size_t unit, cmp_type *cmp) {
+    size_t child;
+    while((child = 2*root + 1) < n) {
+        if(child + 1 < n && cmp(load(at(base, child, unit), unit),
+                    load(at(base, child + 1, unit), unit)) < 0) {
+            child++;
+        }
+        if(cmp(load(at(base, root, unit), unit),
+                    load(at(base, child, unit), unit)) >= 0) {
+            break;
+        }
+        swap_chunks(at(base, root, unit), at(base, child, unit), unit);
+        root = child;
+    }
+}
+
+static ALWAYS_INLINE void heap_sort(char *base, size_t n, size_t unit,
+        cmp_type *cmp) {
+    for(size_t i = n/2; i > 0; i--) {
+        sift_down(base, i - 1, n, unit, cmp);
+    }
+    for(size_t end = n - 1; end > 0; end--) {
+        swap_chunks(base, at(base, end, unit), unit);
+        sift_down(base, 0, end, unit, cmp);
+    }
+}
+
+// partition around the median of the first, middle and last elements, and
+// return the final index of the pivot.
+static ALWAYS_INLINE size_t partition(char *base, size_t n, size_t unit,
+        cmp_type *cmp) {
+    char *first = base;
+    char *mid = at(base, n/2, unit);
+    char *last = at(base, n - 1, unit);
+    void *pivot;
+    size_t i = 0;
+    size_t j = n;
+    if(cmp(load(mid, unit), load(first, unit)) < 0) {
+        swap_chunks(mid, first, unit);
+    }
+    if(cmp(load(last, unit), load(mid, unit)) < 0) {
+        swap_chunks(last, mid, unit);
+        if(cmp(load(mid, unit), load(first, unit)) < 0) {
+            swap_chunks(mid, first, unit);
+        }
+    }
+    // the pivot stays at index 0 until the end, so its pointer is stable
+    swap_chunks(first, mid, unit);
+    pivot = load(first, unit);
+    for(;;) {
+        do {
+            i++;
+        } while(i < n && cmp(load(at(base, i, unit), unit), pivot) < 0);
+        do {
+            j--;
+        } while(cmp(load(at(base, j, unit), unit), pivot) > 0);
+        if(i >= j) {
+            break;
+        }
+        swap_chunks(at(base, i, unit), at(base, j, unit), unit);
+    }
+    swap_chunks(first, at(base, j, unit), unit);
+    return j;
+}
+
+static ALWAYS_INLINE void introsort(char *base, size_t n, size_t unit,
+        cmp_type *cmp, int depth, sort_fn *recurse) {
+    while(n > SORT_CUTOFF) {
+        size_t p;
+        if(depth-- == 0) {
+            heap_sort(base, n, unit, cmp);
+            return;
+        }
+        p = partition(base, n, unit, cmp);
+        // recurse into the smaller side to bound the stack depth
+        if(p < n - p - 1) {
+            recurse(base, p, unit, cmp, depth);
+            base = at(base, p + 1, unit);
+            n = n - p - 1;
+        }
+        else {
+            recurse(at(base, p + 1, unit), n - p - 1, unit, cmp, depth);
+            n = p;
+        }
+    }
+    insertion_sort(base, n, unit, cmp);
+}
+
+// the fixed size variants ignore unit and pass a constant size instead
+static void sort_1(char *base, size_t n, size_t unit, cmp_type *cmp,
+        int depth) {
+    (void)unit;
+    introsort(base, n, 1, cmp, depth, sort_1);
+}
+
+static void sort_2(char *base, size_t n, size_t unit, cmp_type *cmp,
+        int depth) {
+    (void)unit;
+    introsort(base, n, 2, cmp, depth, sort_2);
+}
+
+static void sort_4(char *base, size_t n, size_t unit, cmp_type *cmp,
+        int depth) {
+    (void)unit;
+    introsort(base, n, 4, cmp, depth, sort_4);
+}
+
+static void sort_8(char *base, size_t n, size_t unit, cmp_type *cmp,
+        int depth) {
+    (void)unit;
+    introsort(base, n, 8, cmp, depth, sort_8);
+}
+
+static void sort_n(char *base, size_t n, size_t unit, cmp_type *cmp,
+        int depth) {
+    introsort(base, n, unit, cmp, depth, sort_n);
+}
+
+/*
+ * Radix sort
+ */
+
+static ALWAYS_INLINE uint64_t load_key(char *elem, size_t unit) {
+    uint8_t k8;
+    uint16_t k16;
+    uint32_t k32;
+    uint64_t k64;
+    switch(unit) {
+        case 1:
+            memcpy(&k8, elem, 1);
+            return k8;
+        case 2:
+            memcpy(&k16, elem, 2);
+            return k16;
+        case 4:
+            memcpy(&k32, elem, 4);
+            return k32;
+        default:
+            memcpy(&k64, elem, 8);
+            return k64;
+    }
+}
+
+// sorts n elements of src by bytes, using dst as scratch.  Returns the buffer
+// holding the sorted result.
+static ALWAYS_INLINE char *radix_sort(char *src, char *dst, size_t n,
+        size_t unit, bool is_signed) {
+    size_t counts[256];
+    for(size_t digit = 0; digit < unit; digit++) {
+        unsigned shift = 8*digit;
+        // flipping the sign bit orders negative numbers first
+        unsigned flip = (is_signed && digit == unit - 1) ? 0x80:0;
+        size_t total = 0;
+        char *tmp;
+        memset(counts, 0, sizeof(counts));
+        for(size_t i = 0; i < n; i++) {
+            char *elem = at(src, i, unit);
+            counts[((load_key(elem, unit) >> shift) & 0xff) ^ flip]++;
+        }
+        // skip passes which would not move anything
+        if(counts[((load_key(src, unit) >> shift) & 0xff) ^ flip] == n) {
+            continue;
+        }
+        for(size_t d = 0; d < 256; d++) {
+            size_t count = counts[d];
+            counts[d] = total;
+            total += count;
+        }
+        for(size_t i = 0; i < n; i++) {
+            char *elem = at(src, i, unit);
+            size_t d = ((load_key(elem, unit) >> shift) & 0xff) ^ flip;
+            memcpy(at(dst, counts[d]++, unit), elem, unit);
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    return src;
+}
+
+int array_radix_sort(array_t *self, bool is_signed) {
+    int64_t size = array_size(self);
+    int status = ALC_ARRAY_SUCCESS;
+    size_t unit;
+    char *scratch = NULL;
+    char *sorted = NULL;
+    if(size < 0) {
+        DBG_LOG("Array state was invalid on radix sort operation\n");
+        status = ALC_ARRAY_INVALID;
+        goto invalid_status;
+    }
+    unit = self->data->elem_size;
+    if(unit != 1 && unit != 2 && unit != 4 && unit != 8) {
+        DBG_LOG("Radix sort does not support elements of %zu bytes\n", unit);
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    if(size < 2) {
+        goto done;
+    }
+    scratch = malloc(size*unit);
+    if(scratch == NULL) {
+        DBG_LOG("Could not allocate radix sort scratch buffer\n");
+        status = ALC_ARRAY_NO_MEM;
+        goto done;
+    }
+    switch(unit) {
+        case 1:
+            sorted = radix_sort(array_data(self), scratch, size, 1, is_signed);
+        break;
+
+        case 2:
+            sorted = radix_sort(array_data(self), scratch, size, 2, is_signed);
+        break;
+
+        case 4:
+            sorted = radix_sort(array_data(self), scratch, size, 4, is_signed);
+        break;
+
+        default:
+            sorted = radix_sort(array_data(self), scratch, size, 8, is_signed);
+        break;
+    }
+    if(sorted != array_data(self)) {
+        memcpy(array_data(self), sorted, size*unit);
+    }
+    free(scratch);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+/*
+ * Searching
+ */
+
+int64_t array_lower_bound(array_t *self, void *key, cmp_type *cmp) {
+    return bound(self, key, cmp, 0);
+}
+
+
+int64_t array_upper_bound(array_t *self, void *key, cmp_type *cmp) {
+    return bound(self, key, cmp, 1);
+}
+
+
+void **array_bsearch(array_t *self, void *key, cmp_type *cmp) {
+    void **r = NULL;
+    int64_t index = array_lower_bound(self, key, cmp);
+    size_t unit;
+    if(index < 0 || index == (int64_t)self->size) {
+        goto done;
+    }
+    unit = self->data->elem_size;
+    if(cmp(load((char*)array_at_unchecked(self, index), unit), key) == 0) {
+        r = array_at_unchecked(self, index);
+    }
+done:
+    return r;
+}
+
+// index of the first element e for which cmp(e, key) >= below, which is
+// the lower bound for below = 0 and the upper bound for below = 1.
+static int64_t bound(array_t *self, void *key, cmp_type *cmp, int8_t below) {
+    int64_t size = array_size(self);
+    int status = ALC_ARRAY_SUCCESS;
+    size_t unit;
+    size_t lo = 0;
+    size_t n;
+    char *base;
+    if(size < 0) {
+        DBG_LOG("Array state was invalid on search operation\n");
+        status = ALC_ARRAY_INVALID;
+        goto invalid_status;
+    }
+    if(cmp == NULL) {
+        status = ALC_ARRAY_INVALID;
+        goto done;
+    }
+    unit = self->data->elem_size;
+    base = array_data(self);
+    n = size;
+    while(n > 0) {
+        size_t half = n / 2;
+        if(cmp(load(at(base, lo + half, unit), unit), key) < below) {
+            lo += half + 1;
+            n -= half + 1;
+        }
+        else {
+            n = half;
+        }
+    }
+done:
+    self->status = status;
+invalid_status:
+    return (status == ALC_ARRAY_SUCCESS) ? (int64_t)lo:status;
+}
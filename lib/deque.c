@@ -0,0 +1,296 @@
+#include <alibc/containers/deque.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define map_slot(self, idx) ((dynabuf_t**)dynabuf_at((self)->map, (idx)))
+#define map_capacity(self) ((self)->map->capacity / sizeof(dynabuf_t*))
+
+// private functions
+static int check_valid(deque_t *self);
+static int make_room(deque_t *self, int front);
+static dynabuf_t *take_block(deque_t *self);
+static void retire_block(deque_t *self, dynabuf_t *block);
+
+
+deque_t *create_deque(size_t block_elems, size_t unit) {
+    deque_t *r = NULL;
+    size_t shift = 0;
+    if(unit == 0) {
+        DBG_LOG("Deque elements must be non-empty\n");
+        goto done;
+    }
+    if(block_elems == 0) {
+        block_elems = ALC_DEQUE_BLOCK_BYTES / unit;
+    }
+    while(((size_t)1 << shift) < block_elems
+            && shift < sizeof(size_t)*CHAR_BIT - 1) {
+        shift++;
+    }
+    block_elems = (size_t)1 << shift;
+    if(block_elems > SIZE_MAX / unit) {
+        DBG_LOG("Deque blocks of %zu elements are too large\n", block_elems);
+        goto done;
+    }
+
+    r = malloc(sizeof(deque_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc deque_t\n");
+        goto done;
+    }
+    r->map = create_dynabuf(8, sizeof(dynabuf_t*));
+    if(r->map == NULL) {
+        DBG_LOG("Could not create block map for deque\n");
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->spare        = NULL;
+    r->map_first    = 4;
+    r->nblocks      = 0;
+    r->head         = 0;
+    r->size         = 0;
+    r->block_elems  = block_elems;
+    r->block_shift  = shift;
+    r->elem_size    = unit;
+    r->status       = ALC_DEQUE_SUCCESS;
+done:
+    return r;
+}
+
+
+int deque_push_back(deque_t *self, void *item) {
+    dynabuf_t *block;
+    size_t pos;
+    int status = check_valid(self);
+    if(status != ALC_DEQUE_SUCCESS) {
+        DBG_LOG("Deque state was invalid on push_back operation\n");
+        goto invalid_status;
+    }
+    pos = self->head + self->size;
+    if((pos >> self->block_shift) == self->nblocks) {
+        // the last block is full, or there are no blocks yet
+        status = make_room(self, 0);
+        if(status != ALC_DEQUE_SUCCESS) {
+            goto done;
+        }
+        block = take_block(self);
+        if(block == NULL) {
+            status = ALC_DEQUE_NO_MEM;
+            goto done;
+        }
+        *map_slot(self, self->map_first + self->nblocks) = block;
+        self->nblocks++;
+    }
+    block = *map_slot(self, self->map_first + (pos >> self->block_shift));
+    dynabuf_set(block, pos & (self->block_elems - 1), item);
+    self->size++;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int deque_push_front(deque_t *self, void *item) {
+    dynabuf_t *block;
+    int status = check_valid(self);
+    if(status != ALC_DEQUE_SUCCESS) {
+        DBG_LOG("Deque state was invalid on push_front operation\n");
+        goto invalid_status;
+    }
+    if(self->head == 0) {
+        // the first block is full, or there are no blocks yet
+        status = make_room(self, 1);
+        if(status != ALC_DEQUE_SUCCESS) {
+            goto done;
+        }
+        block = take_block(self);
+        if(block == NULL) {
+            status = ALC_DEQUE_NO_MEM;
+            goto done;
+        }
+        self->map_first--;
+        *map_slot(self, self->map_first) = block;
+        self->nblocks++;
+        self->head = self->block_elems;
+    }
+    self->head--;
+    block = *map_slot(self, self->map_first);
+    dynabuf_set(block, self->head, item);
+    self->size++;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+void **deque_pop_back(deque_t *self) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_DEQUE_SUCCESS) {
+        DBG_LOG("Deque state was invalid on pop_back operation\n");
+        goto invalid_status;
+    }
+    if(self->size == 0) {
+        status = ALC_DEQUE_IDX_OOB;
+        goto done;
+    }
+    self->size--;
+    r = deque_at_unchecked(self, self->size);
+    if(self->size == 0 || ((self->head + self->size) & (self->block_elems - 1))
+            == 0) {
+        // the last block no longer holds any elements
+        self->nblocks--;
+        retire_block(self, *map_slot(self, self->map_first + self->nblocks));
+    }
+    if(self->size == 0) {
+        self->head = 0;
+    }
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+void **deque_pop_front(deque_t *self) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_DEQUE_SUCCESS) {
+        DBG_LOG("Deque state was invalid on pop_front operation\n");
+        goto invalid_status;
+    }
+    if(self->size == 0) {
+        status = ALC_DEQUE_IDX_OOB;
+        goto done;
+    }
+    r = deque_at_unchecked(self, 0);
+    self->head++;
+    self->size--;
+    if(self->size == 0 || self->head == self->block_elems) {
+        // the first block no longer holds any elements
+        retire_block(self, *map_slot(self, self->map_first));
+        self->map_first++;
+        self->nblocks--;
+        self->head = 0;
+    }
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+void **deque_fetch(deque_t *self, size_t which) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_DEQUE_SUCCESS) {
+        DBG_LOG("Deque state was invalid on fetch operation\n");
+        goto invalid_status;
+    }
+    if(which >= self->size) {
+        DBG_LOG("Requested fetch index was out of bounds: %zu\n", which);
+        status = ALC_DEQUE_IDX_OOB;
+        goto done;
+    }
+    r = deque_at_unchecked(self, which);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int64_t deque_size(deque_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_DEQUE_SUCCESS) {
+        size = self->size;
+    }
+    return size;
+}
+
+
+void deque_free(deque_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    if(self->map != NULL) {
+        for(size_t i = 0; i < self->nblocks; i++) {
+            dynabuf_free(*map_slot(self, self->map_first + i));
+        }
+        dynabuf_free(self->map);
+    }
+    dynabuf_free(self->spare);
+    free(self);
+}
+
+
+int deque_status(deque_t *self) {
+    return (self == NULL) ? ALC_DEQUE_INVALID:self->status;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(deque_t *self) {
+    int status = ALC_DEQUE_SUCCESS;
+    if(self == NULL || self->map == NULL) {
+        status = ALC_DEQUE_INVALID;
+    }
+    return status;
+}
+
+// make sure there is a free map slot before the first block (front) or after
+// the last one.  The used slots are re-centered, growing the map when it is
+// more than half full, so that either end has room for nblocks/2 more blocks.
+static int make_room(deque_t *self, int front) {
+    int status = ALC_DEQUE_SUCCESS;
+    size_t capacity = map_capacity(self);
+    size_t first;
+    if(front ? self->map_first > 0
+            :self->map_first + self->nblocks < capacity) {
+        goto done;
+    }
+    if(self->nblocks + 2 > capacity / 2) {
+        if(dynabuf_resize(self->map,
+                dynabuf_grow_count(self->map, 2*self->nblocks + 4))
+                != ALC_DYNABUF_SUCCESS) {
+            DBG_LOG("Could not grow deque block map\n");
+            status = ALC_DEQUE_NO_MEM;
+            goto done;
+        }
+        capacity = map_capacity(self);
+    }
+    first = (capacity - self->nblocks) / 2;
+    memmove(
+        map_slot(self, first), map_slot(self, self->map_first),
+        self->nblocks*sizeof(dynabuf_t*)
+    );
+    self->map_first = first;
+done:
+    return status;
+}
+
+static dynabuf_t *take_block(deque_t *self) {
+    dynabuf_t *r = self->spare;
+    if(r != NULL) {
+        self->spare = NULL;
+    }
+    else {
+        r = create_dynabuf(self->block_elems, self->elem_size);
+    }
+    return r;
+}
+
+// the newest empty block is kept, since a popped element may still be read
+// from it.
+static void retire_block(deque_t *self, dynabuf_t *block) {
+    dynabuf_free(self->spare);
+    self->spare = block;
+}
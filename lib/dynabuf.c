@@ -1,13 +1,36 @@
+#ifdef __linux__
+// mremap
+#define _GNU_SOURCE
+#endif
 #include <alibc/containers/debug.h>
 #include <alibc/containers/dynabuf.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
+#if defined(__unix__) || defined(__APPLE__)
+#define ALC_DYNABUF_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 static int check_valid(dynabuf_t*);
+static int resize_heap(dynabuf_t*, size_t);
+static int resize_reserved(dynabuf_t*, size_t);
+static int resize_mapped(dynabuf_t*, size_t);
+static int resize_borrowed(dynabuf_t*, size_t);
+static size_t page_round(size_t);
+static char *alloc_aligned(size_t, size_t);
 
 
 // SIZE IN BYTES
-dynabuf_t *create_dynabuf(int size, int unit) {
+dynabuf_t *create_dynabuf(size_t size, size_t unit) {
+    if(unit != 0 && size > SIZE_MAX / unit) {
+        DBG_LOG("Requested dynabuf size overflows: %zu*%zu\n", size, unit);
+        return NULL;
+    }
     dynabuf_t *r       = malloc(sizeof(dynabuf_t));
     if(r == NULL)   {
         DBG_LOG("Could not malloc dynabuf\n");
@@ -23,38 +46,335 @@ dynabuf_t *create_dynabuf(int size, int unit) {
     memset(r->buf, 0, size*unit);
     r->capacity     = size*unit; // capacity is always in bytes for dynabuf.
     r->elem_size = unit;
+    r->reserved  = 0;
+    r->header    = 0;
+    r->growth    = ALC_DYNABUF_GROW_DOUBLE;
+    r->mode      = ALC_DYNABUF_HEAP;
+    r->fd        = -1;
+    r->align     = 0;
+    return r;
+}
+
+
+dynabuf_t *create_dynabuf_aligned(size_t size, size_t unit, size_t align) {
+    dynabuf_t *r = NULL;
+    if(align == 0) {
+        r = create_dynabuf(size, unit);
+        goto done;
+    }
+    if((align & (align - 1)) != 0 || align % sizeof(void*) != 0) {
+        DBG_LOG("Alignment %zu is not a power of two multiple of %zu\n",
+                align, sizeof(void*));
+        goto done;
+    }
+    if(unit != 0 && size > SIZE_MAX / unit) {
+        DBG_LOG("Requested dynabuf size overflows: %zu*%zu\n", size, unit);
+        goto done;
+    }
+    r = malloc(sizeof(dynabuf_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc dynabuf\n");
+        goto done;
+    }
+    r->buf = alloc_aligned(size*unit, align);
+    if(r->buf == NULL) {
+        DBG_LOG("Could not allocate %zu-byte aligned array\n", align);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+
+    memset(r->buf, 0, size*unit);
+    r->capacity     = size*unit;
+    r->elem_size    = unit;
+    r->reserved     = 0;
+    r->header       = 0;
+    r->growth       = ALC_DYNABUF_GROW_DOUBLE;
+    r->mode         = ALC_DYNABUF_HEAP;
+    r->fd           = -1;
+    r->align        = align;
+done:
+    return r;
+}
+
+
+int dynabuf_init(dynabuf_t *target, void *buf, size_t size, size_t unit) {
+    int status = ALC_DYNABUF_SUCCESS;
+    if(target == NULL || buf == NULL || unit == 0 || size > SIZE_MAX / unit) {
+        status = ALC_DYNABUF_INVALID;
+        goto done;
+    }
+    target->buf         = buf;
+    target->capacity    = size*unit;
+    target->elem_size   = unit;
+    target->reserved    = 0;
+    target->header      = 0;
+    target->growth      = ALC_DYNABUF_GROW_DOUBLE;
+    target->mode        = ALC_DYNABUF_BORROWED;
+    target->fd          = -1;
+    target->align       = 0;
+done:
+    return status;
+}
+
+
+dynabuf_t *create_dynabuf_reserved(size_t size, size_t unit, size_t max) {
+    dynabuf_t *r = NULL;
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    size_t reserved;
+    if(unit == 0 || max < size || max > SIZE_MAX / unit
+            || page_round(max*unit) < max*unit) {
+        DBG_LOG("Invalid reservation: %zu of %zu*%zu\n", size, max, unit);
+        goto done;
+    }
+    reserved = page_round(max*unit);
+
+    r = malloc(sizeof(dynabuf_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc dynabuf\n");
+        goto done;
+    }
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    // reserve the whole range inaccessible, and commit only what is needed.
+    r->buf = mmap(NULL, reserved, PROT_NONE, flags, -1, 0);
+    if(r->buf == MAP_FAILED) {
+        DBG_LOG("Could not reserve %zu bytes\n", reserved);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->capacity     = 0;
+    r->elem_size    = unit;
+    r->reserved     = reserved;
+    r->header       = 0;
+    r->growth       = ALC_DYNABUF_GROW_DOUBLE;
+    r->mode         = ALC_DYNABUF_RESERVED;
+    r->fd           = -1;
+    r->align        = 0;
+    // freshly committed anonymous pages are zero-filled.
+    if(resize_reserved(r, size*unit) != ALC_DYNABUF_SUCCESS) {
+        DBG_LOG("Could not commit %zu bytes\n", size*unit);
+        dynabuf_free(r);
+        r = NULL;
+        goto done;
+    }
+done:
+#else
+    DBG_LOG("Address space reservation is not supported\n");
+#endif
+    return r;
+}
+
+
+dynabuf_t *create_dynabuf_mmap(const char *path, size_t size, size_t unit,
+        size_t header) {
+    dynabuf_t *r = NULL;
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    struct stat st;
+    size_t length;
+    size_t extra;
+    char *base;
+    if(path == NULL || unit == 0 || size > (SIZE_MAX - header) / unit) {
+        DBG_LOG("Invalid file mapping request\n");
+        goto done;
+    }
+
+    r = malloc(sizeof(dynabuf_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc dynabuf\n");
+        goto done;
+    }
+    r->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(r->fd < 0 || fstat(r->fd, &st) != 0) {
+        DBG_LOG("Could not open %s\n", path);
+        goto fail;
+    }
+
+    // keep whatever the file already holds, growing it if it is too small.
+    // A partial trailing element is padded out so that the mapping always
+    // covers exactly header + capacity bytes.
+    length = header + size*unit;
+    if((size_t)st.st_size > length) {
+        extra = ((size_t)st.st_size - header) % unit;
+        if(extra > 0 && (size_t)st.st_size > SIZE_MAX - (unit - extra)) {
+            DBG_LOG("Size of %s overflows\n", path);
+            goto fail;
+        }
+        length = st.st_size + (extra > 0 ? unit - extra:0);
+    }
+    if((size_t)st.st_size != length) {
+        if(ftruncate(r->fd, length) != 0) {
+            DBG_LOG("Could not extend %s to %zu bytes\n", path, length);
+            goto fail;
+        }
+    }
+    if(length == 0) {
+        DBG_LOG("Cannot map an empty file\n");
+        goto fail;
+    }
+
+    base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, r->fd, 0);
+    if(base == MAP_FAILED) {
+        DBG_LOG("Could not map %s\n", path);
+        goto fail;
+    }
+    r->buf          = base + header;
+    r->capacity     = length - header;
+    r->elem_size    = unit;
+    r->reserved     = 0;
+    r->header       = header;
+    r->growth       = ALC_DYNABUF_GROW_DOUBLE;
+    r->mode         = ALC_DYNABUF_MAPPED;
+    r->align        = 0;
+    goto done;
+
+fail:
+    if(r->fd >= 0) {
+        close(r->fd);
+    }
+    free(r);
+    r = NULL;
+done:
+#else
+    DBG_LOG("File mapping is not supported\n");
+#endif
+    return r;
+}
+
+
+void *dynabuf_header(dynabuf_t *target) {
+    void *r = NULL;
+    if(check_valid(target) == ALC_DYNABUF_SUCCESS && target->header > 0) {
+        r = target->buf - target->header;
+    }
     return r;
 }
 
 
+int dynabuf_flush(dynabuf_t *target) {
+    int status = check_valid(target);
+    if(status != ALC_DYNABUF_SUCCESS) {
+        goto done;
+    }
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    if(target->mode == ALC_DYNABUF_MAPPED) {
+        if(msync(target->buf - target->header,
+                    target->header + target->capacity, MS_SYNC) != 0) {
+            DBG_LOG("Could not sync mapped buffer\n");
+            status = ALC_DYNABUF_INVALID;
+        }
+    }
+#endif
+done:
+    return status;
+}
+
+
 // SIZE IN ELEMENTS
-int dynabuf_resize(dynabuf_t *target, int size) {
+int dynabuf_resize(dynabuf_t *target, size_t size) {
     int status = check_valid(target);
-    char *newbuf = NULL;
     if(status != ALC_DYNABUF_SUCCESS) {
         DBG_LOG("Target was not valid: %d\n", status);
         goto done;
     }
-
-    newbuf  = realloc(target->buf, size*target->elem_size);
-    if(newbuf == NULL)  {
-        DBG_LOG("Could not realloc buffer\n");
+    if(size > SIZE_MAX / target->elem_size) {
+        DBG_LOG("Requested resize overflows: %zu elements\n", size);
         status = ALC_DYNABUF_NO_MEM;
         goto done;
     }
-    if(newbuf != target->buf)    {
-        DBG_LOG("realloc moved target->buf, was: %p, is:%p\n",
-                target->buf, newbuf);
-        target->buf = newbuf;
+
+    switch(target->mode) {
+        case ALC_DYNABUF_RESERVED:
+            status = resize_reserved(target, size*target->elem_size);
+        break;
+
+        case ALC_DYNABUF_MAPPED:
+            status = resize_mapped(target, size*target->elem_size);
+        break;
+
+        case ALC_DYNABUF_BORROWED:
+            status = resize_borrowed(target, size*target->elem_size);
+        break;
+
+        default:
+            status = resize_heap(target, size*target->elem_size);
+        break;
     }
-    target->capacity = size*target->elem_size;
 
 done:
     return status;
 }
 
 
-int dynabuf_set(dynabuf_t *target, int which, void *element) {
+int dynabuf_set_growth(dynabuf_t *target, int policy) {
+    int status = check_valid(target);
+    if(status != ALC_DYNABUF_SUCCESS) {
+        goto done;
+    }
+    switch(policy) {
+        case ALC_DYNABUF_GROW_DOUBLE:
+        case ALC_DYNABUF_GROW_HALF:
+        case ALC_DYNABUF_GROW_PAGE:
+            target->growth = policy;
+        break;
+
+        default:
+            DBG_LOG("Unknown growth policy %d\n", policy);
+            status = ALC_DYNABUF_INVALID;
+        break;
+    }
+done:
+    return status;
+}
+
+
+size_t dynabuf_grow_count(dynabuf_t *target, size_t min_count) {
+    size_t count = 0;
+    size_t max_count;
+    size_t current;
+    if(check_valid(target) != ALC_DYNABUF_SUCCESS) {
+        goto done;
+    }
+    max_count = SIZE_MAX / target->elem_size;
+    current = target->capacity / target->elem_size;
+
+    // saturate rather than overflow, the allocation will fail instead.
+    switch(target->growth) {
+        case ALC_DYNABUF_GROW_HALF:
+        case ALC_DYNABUF_GROW_PAGE:
+            count = (current > (max_count - 1) / 3 * 2) ?
+                max_count:current + current/2 + 1;
+        break;
+
+        default:
+            count = (current > (max_count - 1) / 2) ?
+                max_count:2*current + 1;
+        break;
+    }
+    // reserved buffers cannot grow past their reservation
+    if(target->mode == ALC_DYNABUF_RESERVED
+            && count > target->reserved / target->elem_size) {
+        count = target->reserved / target->elem_size;
+    }
+    count = (count < min_count) ? min_count:count;
+
+    if(target->growth == ALC_DYNABUF_GROW_PAGE && count < max_count) {
+        size_t bytes = count * target->elem_size;
+        if(bytes <= SIZE_MAX - (ALC_DYNABUF_PAGE_SIZE - 1)) {
+            bytes = (bytes + ALC_DYNABUF_PAGE_SIZE - 1)
+                & ~(size_t)(ALC_DYNABUF_PAGE_SIZE - 1);
+            count = bytes / target->elem_size;
+        }
+    }
+done:
+    return count;
+}
+
+
+int dynabuf_set(dynabuf_t *target, size_t which, void *element) {
     int status = check_valid(target);
     if(status != ALC_DYNABUF_SUCCESS) {
         goto done;
@@ -78,14 +398,14 @@ done:
 }
 
 
-int dynabuf_set_seq(dynabuf_t *target, int which, int next,
+int dynabuf_set_seq(dynabuf_t *target, size_t which, int next,
         void *value, int size) {
     int next_idx = 0;
     if(check_valid(target) != ALC_DYNABUF_SUCCESS) {
         next_idx = -1;
         goto done;
     }
-    if(next + size > target->elem_size || next < 0) {
+    if(next < 0 || size < 0 || (size_t)next + size > target->elem_size) {
         next_idx = -1;
         goto done;
     }
@@ -104,13 +424,13 @@ int dynabuf_set_seq(dynabuf_t *target, int which, int next,
         );
     }
     next_idx += size;
-    next_idx = next_idx >= target->elem_size ? 0: next_idx;
+    next_idx = (size_t)next_idx >= target->elem_size ? 0: next_idx;
 done:
     return next_idx;
 }
 
 
-void **dynabuf_fetch(dynabuf_t *target, int which) {
+void **dynabuf_fetch(dynabuf_t *target, size_t which) {
     void **r = NULL;
     if(check_valid(target) != ALC_DYNABUF_SUCCESS) {
         goto done;
@@ -121,17 +441,46 @@ done:
 }
 
 
-void dynabuf_free(dynabuf_t *target)    {
+void dynabuf_release(dynabuf_t *target) {
     if(target == NULL)  {
         return;
     }
-    else if(target->buf == NULL) {
-        free(target);
+    switch(target->mode) {
+#ifdef ALC_DYNABUF_HAVE_MMAP
+        case ALC_DYNABUF_RESERVED:
+            if(target->buf != NULL) {
+                munmap(target->buf, target->reserved);
+            }
+        break;
+
+        case ALC_DYNABUF_MAPPED:
+            if(target->buf != NULL) {
+                munmap(target->buf - target->header,
+                        target->header + target->capacity);
+            }
+            close(target->fd);
+        break;
+#endif
+
+        case ALC_DYNABUF_BORROWED:
+            // the caller owns the buffer
+        break;
+
+        default:
+            free(target->buf);
+        break;
     }
-    else    {
-        free(target->buf);
-        free(target);
+    target->buf = NULL;
+    target->capacity = 0;
+}
+
+
+void dynabuf_free(dynabuf_t *target)    {
+    if(target == NULL)  {
+        return;
     }
+    dynabuf_release(target);
+    free(target);
 }
 
 
@@ -145,10 +494,179 @@ static int check_valid(dynabuf_t *self)  {
         status = ALC_DYNABUF_INVALID;
         goto done;
     }
-    if(self->capacity == 0)  {
+    // reserved and mapped buffers may legitimately be empty
+    if(self->capacity == 0 && self->mode == ALC_DYNABUF_HEAP)  {
         status = ALC_DYNABUF_NO_MEM;
         goto done;
     }
 done:
     return status;
 }
+
+// SIZE IN BYTES
+static int resize_heap(dynabuf_t *target, size_t bytes) {
+    int status = ALC_DYNABUF_SUCCESS;
+    char *newbuf;
+    if(target->align != 0) {
+        // realloc does not preserve alignment, so aligned buffers are copied
+        newbuf = alloc_aligned(bytes, target->align);
+        if(newbuf == NULL) {
+            DBG_LOG("Could not allocate aligned buffer\n");
+            status = ALC_DYNABUF_NO_MEM;
+            goto done;
+        }
+        memcpy(newbuf, target->buf,
+                bytes < target->capacity ? bytes:target->capacity);
+        free(target->buf);
+        target->buf = newbuf;
+        target->capacity = bytes;
+        goto done;
+    }
+    newbuf = realloc(target->buf, bytes);
+    if(newbuf == NULL)  {
+        DBG_LOG("Could not realloc buffer\n");
+        status = ALC_DYNABUF_NO_MEM;
+        goto done;
+    }
+    if(newbuf != target->buf)    {
+        DBG_LOG("realloc moved target->buf, was: %p, is:%p\n",
+                target->buf, newbuf);
+        target->buf = newbuf;
+    }
+    target->capacity = bytes;
+done:
+    return status;
+}
+
+// SIZE IN BYTES
+static int resize_reserved(dynabuf_t *target, size_t bytes) {
+    int status = ALC_DYNABUF_NO_MEM;
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    size_t committed = page_round(target->capacity);
+    size_t needed = page_round(bytes);
+    if(bytes > target->reserved) {
+        DBG_LOG("Resize to %zu bytes exceeds reservation of %zu\n",
+                bytes, target->reserved);
+        goto done;
+    }
+    if(needed > committed) {
+        if(mprotect(target->buf + committed, needed - committed,
+                    PROT_READ | PROT_WRITE) != 0) {
+            DBG_LOG("Could not commit %zu bytes\n", needed - committed);
+            goto done;
+        }
+    }
+    else if(needed < committed) {
+        // hand the pages back to the system, and make them inaccessible.
+        madvise(target->buf + needed, committed - needed, MADV_DONTNEED);
+        mprotect(target->buf + needed, committed - needed, PROT_NONE);
+    }
+    target->capacity = bytes;
+    status = ALC_DYNABUF_SUCCESS;
+done:
+#endif
+    return status;
+}
+
+// SIZE IN BYTES
+static int resize_mapped(dynabuf_t *target, size_t bytes) {
+    int status = ALC_DYNABUF_NO_MEM;
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    char *base = target->buf - target->header;
+    size_t old_length = target->header + target->capacity;
+    size_t new_length;
+    if(bytes > SIZE_MAX - target->header) {
+        goto done;
+    }
+    new_length = target->header + bytes;
+    if(new_length == 0) {
+        DBG_LOG("Cannot map an empty file\n");
+        goto done;
+    }
+    if(ftruncate(target->fd, new_length) != 0) {
+        DBG_LOG("Could not resize backing file to %zu bytes\n", new_length);
+        goto done;
+    }
+#ifdef __linux__
+    base = mremap(base, old_length, new_length, MREMAP_MAYMOVE);
+    if(base == MAP_FAILED) {
+        DBG_LOG("Could not remap backing file\n");
+        // the old mapping is untouched, restore the file to match it.
+        if(ftruncate(target->fd, old_length) != 0) {
+            DBG_LOG("Could not restore backing file size\n");
+        }
+        goto done;
+    }
+#else
+    munmap(base, old_length);
+    base = mmap(NULL, new_length, PROT_READ | PROT_WRITE, MAP_SHARED,
+            target->fd, 0);
+    if(base == MAP_FAILED) {
+        DBG_LOG("Could not remap backing file\n");
+        // the old mapping is gone, leave the dynabuf invalid.
+        target->buf = NULL;
+        target->capacity = 0;
+        goto done;
+    }
+#endif
+    target->buf = base + target->header;
+    target->capacity = bytes;
+    status = ALC_DYNABUF_SUCCESS;
+done:
+#endif
+    return status;
+}
+
+// SIZE IN BYTES
+static int resize_borrowed(dynabuf_t *target, size_t bytes) {
+    int status = ALC_DYNABUF_SUCCESS;
+    char *newbuf = malloc(bytes);
+    if(newbuf == NULL) {
+        DBG_LOG("Could not move borrowed buffer to the heap\n");
+        status = ALC_DYNABUF_NO_MEM;
+        goto done;
+    }
+    memcpy(newbuf, target->buf,
+            bytes < target->capacity ? bytes:target->capacity);
+    target->buf = newbuf;
+    target->capacity = bytes;
+    target->mode = ALC_DYNABUF_HEAP;
+done:
+    return status;
+}
+
+// allocations are always freed with free()
+static char *alloc_aligned(size_t bytes, size_t align) {
+    void *r = NULL;
+    if(bytes > SIZE_MAX - align) {
+        return NULL;
+    }
+    // aligned_alloc wants a whole number of alignment units, and huge page
+    // backed buffers are rounded up to whole huge pages so that the tail of
+    // the buffer does not fall back to small pages.  Empty requests get one
+    // unit, since either allocator may return NULL for them.
+    bytes = bytes ? (bytes + align - 1) & ~(align - 1):align;
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    if(posix_memalign(&r, align, bytes) != 0) {
+        return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    if(align >= ALC_DYNABUF_ALIGN_HUGE
+            && madvise(r, bytes, MADV_HUGEPAGE) != 0) {
+        // only a hint, the buffer is still usable
+        DBG_LOG("Transparent huge pages are unavailable\n");
+    }
+#endif
+#else
+    r = aligned_alloc(align, bytes);
+#endif
+    return r;
+}
+
+static size_t page_round(size_t bytes) {
+    size_t page = ALC_DYNABUF_PAGE_SIZE;
+#ifdef ALC_DYNABUF_HAVE_MMAP
+    page = sysconf(_SC_PAGESIZE);
+#endif
+    return (bytes + page - 1) & ~(page - 1);
+}
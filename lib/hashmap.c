@@ -13,17 +13,19 @@
 
 
 // Private functions
-static int rehash(hashmap_t *self, int count);
+static int rehash(hashmap_t *self, size_t count);
 static int check_valid(hashmap_t *self);
-static int check_space_available(hashmap_t *self, int size);
-static int hashmap_locate(hashmap_t *, void *);
-static inline bool default_load(int, int);
+static int check_space_available(hashmap_t *self, size_t size);
+static int64_t hashmap_locate(hashmap_t *, void *);
+static inline bool default_load(size_t, size_t);
+static inline void *load_key(hashmap_t *self, size_t idx);
+static dynabuf_t *create_table(size_t count, size_t unit);
 
 
 
 
-hashmap_t *create_hashmap(int size, int keysz, int valsz, hash_type *hashfn,
-        cmp_type *comparefn, load_type loadfn) {
+hashmap_t *create_hashmap(size_t size, size_t keysz, size_t valsz,
+        hash_type *hashfn, cmp_type *comparefn, load_type loadfn) {
 
     hashmap_t *r = malloc(sizeof(hashmap_t));
     if(r == NULL)  {
@@ -31,7 +33,7 @@ hashmap_t *create_hashmap(int size, int keysz, int valsz, hash_type *hashfn,
         goto done;
     }
 
-    r->map    = create_dynabuf(size, keysz + valsz);
+    r->map    = create_table(size, keysz + valsz);
     if(r->map == NULL)    {
         DBG_LOG("Could not create new array for hashmap\n");
         free(r);
@@ -44,9 +46,18 @@ hashmap_t *create_hashmap(int size, int keysz, int valsz, hash_type *hashfn,
         free(r);
         goto done;
     }
+    r->_removed = create_bitmap(size);
+    if(r->_removed == NULL)    {
+        DBG_LOG("Could not create removal map for hashmap\n");
+        bitmap_free(r->_filter);
+        dynabuf_free(r->map);
+        free(r);
+        goto done;
+    }
 
     memset(r->map->buf, 0, size*(keysz + valsz));
     memset(r->_filter->buf, 0, filter_size_constraint(size));
+    memset(r->_removed->buf, 0, filter_size_constraint(size));
 
     r->hash     = hashfn;
 
@@ -60,6 +71,7 @@ hashmap_t *create_hashmap(int size, int keysz, int valsz, hash_type *hashfn,
     r->val_offset = keysz;
     r->compare  = comparefn;
     r->entries  = 0;
+    r->removed  = 0;
     r->capacity = size;
     r->status   = ALC_HASHMAP_SUCCESS;
     
@@ -70,21 +82,37 @@ done:
 int hashmap_set(hashmap_t *self, void *key, void *value)    {
     int status;
     uint32_t hash;
-    int index;
+    size_t index;
+    size_t reuse;
 
     switch((status = check_space_available(self, 1)))   {
         case ALC_HASHMAP_SUCCESS:
             hash        = self->hash(key);
             index       = hash % self->capacity;
+            reuse       = self->capacity;
             // index guaranteed in range
-            // scan for next open entry
-            while(bitmap_contains(self->_filter, index))    {
-                if(self->compare(key, *key_at(self, index)) == 0) {
-                    DBG_LOG("got repeat key case\n");
-                    goto repeat_key;
+            // scan up to the next never used entry, as the key may lie beyond
+            // removed entries.  The first removed entry is reused.
+            for(size_t i = 0; i < self->capacity; i++) {
+                if(bitmap_contains(self->_filter, index)) {
+                    if(self->compare(key, load_key(self, index)) == 0) {
+                        DBG_LOG("got repeat key case\n");
+                        goto repeat_key;
+                    }
+                }
+                else if(!bitmap_contains(self->_removed, index)) {
+                    break;
+                }
+                else if(reuse == self->capacity) {
+                    reuse = index;
                 }
                 index = (index + 1) % self->capacity;
             }
+            if(reuse != self->capacity) {
+                index = reuse;
+                bitmap_remove(self->_removed, index);
+                self->removed--;
+            }
             self->entries++;
             int next = 0;
 repeat_key:
@@ -114,6 +142,10 @@ repeat_key:
     if(self->load(self->entries, self->capacity) != 0) {
         status = hashmap_resize(self, 2*self->capacity + 1);
     }
+    else if(self->load(self->entries + self->removed, self->capacity) != 0) {
+        // removed entries lengthen probes, so clear them out in place
+        status = hashmap_resize(self, self->capacity);
+    }
 done:
     self->status = status;
 invalid_status:
@@ -123,7 +155,7 @@ invalid_status:
 
 void **hashmap_fetch(hashmap_t *self, void *key) {
     int status = check_valid(self);
-    int key_index;
+    int64_t key_index;
     void **r = NULL;
     if(status != ALC_HASHMAP_SUCCESS) {
         DBG_LOG("hashmap was invalid on fetch operation.\n");
@@ -145,7 +177,7 @@ invalid_status:
 
 void **hashmap_remove(hashmap_t *self, void *key)  {
     int status = check_valid(self);
-    int key_index;
+    int64_t key_index;
     void **r = NULL;
     if(status != ALC_HASHMAP_SUCCESS) {
         DBG_LOG("check_valid returned invalid status: %d\n", status);
@@ -155,6 +187,9 @@ void **hashmap_remove(hashmap_t *self, void *key)  {
     if(key_index != -1) {
         r = value_at(self, key_index);
         bitmap_remove(self->_filter, key_index);
+        bitmap_add(self->_removed, key_index);
+        self->entries--;
+        self->removed++;
     }
     else {
         status = ALC_HASHMAP_NOTFOUND;
@@ -165,7 +200,7 @@ invalid_status:
     return r;
 }
 
-int hashmap_resize(hashmap_t *self, int count) {
+int hashmap_resize(hashmap_t *self, size_t count) {
     int status = check_valid(self);
     if(status != ALC_HASHMAP_SUCCESS) {
         goto invalid_status;
@@ -174,13 +209,13 @@ int hashmap_resize(hashmap_t *self, int count) {
     if(count > self->entries) {
         status = rehash(self, count);
         if(status != ALC_HASHMAP_SUCCESS) {
-            DBG_LOG("Could not rehash to new size %d\n", count);
+            DBG_LOG("Could not rehash to new size %zu\n", count);
             status = ALC_HASHMAP_NO_MEM;
             goto done;
         }
     }
     else if(count < self->entries) {
-        DBG_LOG("Requested count %d was too small.\n", count);
+        DBG_LOG("Requested count %zu was too small.\n", count);
         status = ALC_HASHMAP_INVALID_REQ;
         goto done;
     }
@@ -191,9 +226,9 @@ invalid_status:
     return status;
 }
 
-int hashmap_size(hashmap_t *self)   {
+int64_t hashmap_size(hashmap_t *self)   {
     int status = check_valid(self);
-    int size = -1;
+    int64_t size = -1;
     if(status == ALC_HASHMAP_SUCCESS) {
         size = self->entries;
     }
@@ -206,6 +241,7 @@ void hashmap_free(hashmap_t *self)   {
         case ALC_HASHMAP_SUCCESS:
             dynabuf_free(self->map);
             bitmap_free(self->_filter);
+            bitmap_free(self->_removed);
 
         case ALC_HASHMAP_INVALID:
             free(self);
@@ -224,14 +260,14 @@ int hashmap_status(hashmap_t *self)   {
 /*
  * Helper functions
  */
-static int hashmap_locate(hashmap_t *self, void *key)  {
+static int64_t hashmap_locate(hashmap_t *self, void *key)  {
     if(check_valid(self) != ALC_HASHMAP_SUCCESS)    {
         return -1;
     }
 
     uint32_t hash = self->hash(key);
-    int index = hash % self->capacity;
-    int start_index = index;
+    size_t index = hash % self->capacity;
+    size_t start_index = index;
     bool is_valid = 0;
     bool is_equal = 0;
     while(!is_equal || !is_valid)   {
@@ -244,7 +280,7 @@ static int hashmap_locate(hashmap_t *self, void *key)  {
              *null_check  = *(void**)dynabuf_fetch(self->map, index) == NULL;
              *null_check  |= ((key == NULL) << 1);
              */
-            is_equal = self->compare(key, *key_at(self, index)) == 0;
+            is_equal = self->compare(key, load_key(self, index)) == 0;
 /*
  *            switch(null_check) {
  *                case 0: // neither is null
@@ -263,6 +299,10 @@ static int hashmap_locate(hashmap_t *self, void *key)  {
  *            }
  */
         }
+        else if(!bitmap_contains(self->_removed, index)) {
+            // a never used entry ends the probe sequence
+            return -1;
+        }
 
         if(is_equal && is_valid)    {
             break;
@@ -270,18 +310,18 @@ static int hashmap_locate(hashmap_t *self, void *key)  {
         
         index = (index + 1) % self->capacity;
         if(index == start_index)    {
-            index = -1;
-            break;
+            return -1;
         }
 
     }
     return index;
 }
 
-static int rehash(hashmap_t *self, int count)   {
+static int rehash(hashmap_t *self, size_t count)   {
     int status = check_valid(self);
     dynabuf_t *scratch_map;
     dynabuf_t *scratch_filter;
+    dynabuf_t *scratch_removed;
     if(status != ALC_HASHMAP_SUCCESS) {
         DBG_LOG("Invalid status returned from check_valid: %d\n", status);
         goto done;
@@ -292,9 +332,9 @@ static int rehash(hashmap_t *self, int count)   {
         goto done;
     }
 
-    scratch_map     = create_dynabuf(count, self->map->elem_size);
+    scratch_map     = create_table(count, self->map->elem_size);
     if(scratch_map == NULL) {
-        DBG_LOG("Could not create new array with size %d\n",
+        DBG_LOG("Could not create new array with size %zu\n",
                 self->capacity);
         status = ALC_HASHMAP_NO_MEM;
         goto done;
@@ -302,26 +342,37 @@ static int rehash(hashmap_t *self, int count)   {
     
     scratch_filter  = create_bitmap(count);
     if(scratch_filter == NULL) {
-        DBG_LOG("Could not create new array with size %d\n",
+        DBG_LOG("Could not create new array with size %zu\n",
                 self->capacity);
         dynabuf_free(scratch_map);
         status = ALC_HASHMAP_NO_MEM;
         goto done;
     }
 
-    // clear out the new buffer
+    scratch_removed = create_bitmap(count);
+    if(scratch_removed == NULL) {
+        DBG_LOG("Could not create new array with size %zu\n",
+                self->capacity);
+        bitmap_free(scratch_filter);
+        dynabuf_free(scratch_map);
+        status = ALC_HASHMAP_NO_MEM;
+        goto done;
+    }
+
+    // clear out the new buffer, removed entries are not carried over
     memset(scratch_map->buf, 0, count*self->map->elem_size);
     memset(scratch_filter->buf, 0, filter_size_constraint(count));
+    memset(scratch_removed->buf, 0, filter_size_constraint(count));
 
-    for(int i = 0; i < self->capacity; i++)    {
+    for(size_t i = 0; i < self->capacity; i++)    {
         if(!bitmap_contains(self->_filter, i))   {
             continue;
         }
-        uint32_t hash = self->hash(key_at(self, i));
-        int index = hash % count;
+        uint32_t hash = self->hash(load_key(self, i));
+        size_t index = hash % count;
 
         while(bitmap_contains(scratch_filter, index))  {
-            index = (index + 1) % self->capacity;
+            index = (index + 1) % count;
         }
         dynabuf_set(scratch_map, index, dynabuf_fetch(self->map, i));
         bitmap_add(scratch_filter, index);
@@ -329,8 +380,11 @@ static int rehash(hashmap_t *self, int count)   {
 
     dynabuf_free(self->map);
     bitmap_free(self->_filter);
+    bitmap_free(self->_removed);
     self->map       = scratch_map;
     self->_filter   = scratch_filter;
+    self->_removed  = scratch_removed;
+    self->removed   = 0;
     self->capacity  = count;
 done:
     return status;
@@ -358,7 +412,7 @@ int check_valid(hashmap_t *self)    {
         status = ALC_HASHMAP_INVALID;
         goto done;
     }
-    if(self->_filter == NULL) {
+    if(self->_filter == NULL || self->_removed == NULL) {
         status = ALC_HASHMAP_INVALID;
         goto done;
     }
@@ -366,10 +420,10 @@ done:
     return status;
 }
 
-int check_space_available(hashmap_t *self, int size)  {
+int check_space_available(hashmap_t *self, size_t size)  {
     int status = check_valid(self);
     if(status == ALC_HASHMAP_SUCCESS) {
-        status = (self->capacity - (self->entries + size) > 0) ?
+        status = (self->entries + size < self->capacity) ?
             ALC_HASHMAP_SUCCESS:ALC_HASHMAP_NO_MEM;
     }
     else {
@@ -379,10 +433,36 @@ int check_space_available(hashmap_t *self, int size)  {
 }
 
 
+/*
+ * Keys are stored by value, this recovers the key in the same form in which it
+ * was passed to hashmap_set: the value itself for keys which fit in a pointer,
+ * otherwise a pointer to the stored key.
+ */
+static inline void *load_key(hashmap_t *self, size_t idx) {
+    void *r = NULL;
+    if(self->val_offset > sizeof(void*)) {
+        r = key_at(self, idx);
+    }
+    else {
+        memcpy(&r, key_at(self, idx), self->val_offset);
+    }
+    return r;
+}
+
 /*
  * 75% load by default. Chosen arbitrarily.  This function is used when
  * no load function is given to the constructor.
  */
-inline bool default_load(int entries, int capacity)  {
-    return ((float)entries)/((float)capacity) > 0.75f;
+inline bool default_load(size_t entries, size_t capacity)  {
+    return ((double)entries)/((double)capacity) > 0.75;
+}
+
+// tables large enough to span many pages are backed by huge pages, which cuts
+// the TLB misses taken by lookups scattered across the table.
+static dynabuf_t *create_table(size_t count, size_t unit) {
+    size_t align = 0;
+    if(unit != 0 && count >= ALC_DYNABUF_HUGE_THRESHOLD / unit) {
+        align = ALC_DYNABUF_ALIGN_HUGE;
+    }
+    return create_dynabuf_aligned(count, unit, align);
 }
@@ -1,32 +1,37 @@
 #include <alibc/containers/hashmap.h>
-#include <alibc/containers/iterator.h>
+#include <alibc/containers/hashmap_iterator.h>
 #include <stdlib.h>
 #include <stdio.h>
-#define value_at(self, idx) (void**)((char*)dynabuf_fetch(self->map, idx) + self->val_offset)
-#define key_at(self, idx) (void**)((char*)dynabuf_fetch(self->map, idx))
+#define slot_at(self, idx, offset) \
+    ((void**)((char*)dynabuf_at((self)->map, (idx)) + (offset)))
 
-static void **hashmap_iter_keys(iter_context *ctx) {
+/*
+ * Return a pointer offset bytes into the next occupied slot.
+ */
+static void **hashmap_iter_step(iter_context *ctx, size_t offset) {
     void **r = NULL;
     hashmap_t *target = (hashmap_t*)ctx->_data;
-    if(target == NULL) {
-        ctx->status = ALC_ITER_INVALID;
-        goto done;
-    }
-    while(ctx->index < target->capacity
-        && !bitmap_contains(target->_filter, ctx->index)) {
+    size_t end = iter_end(ctx, target->capacity);
+    ctx->index = bitmap_next(target->_filter, ctx->index, end);
+    if(ctx->index < end) {
+        r = slot_at(target, ctx->index, offset);
+        ctx->status = ALC_ITER_CONTINUE;
         ctx->index++;
     }
-    if(bitmap_contains(target->_filter, ctx->index)) {
-        r = key_at(target, ctx->index);
-    }
-
-    if(ctx->index == target->capacity) {
+    else {
         ctx->status = ALC_ITER_STOP;
     }
-    else {
-        ctx->status = ALC_ITER_CONTINUE;
-        ctx->index++;
+    return r;
+}
+
+static void **hashmap_iter_keys(iter_context *ctx) {
+    void **r = NULL;
+    hashmap_t *target = (hashmap_t*)ctx->_data;
+    if(target == NULL) {
+        ctx->status = ALC_ITER_INVALID;
+        goto done;
     }
+    r = hashmap_iter_step(ctx, 0);
 done:
     return r;
 }
@@ -38,47 +43,173 @@ static void **hashmap_iter_values(iter_context *ctx) {
         ctx->status = ALC_ITER_INVALID;
         goto done;
     }
-    while(ctx->index < target->capacity
-        && !bitmap_contains(target->_filter, ctx->index)) {
-        ctx->index++;
+    r = hashmap_iter_step(ctx, target->val_offset);
+done:
+    return r;
+}
+
+/*
+ * Fill out with up to n pointers, each offset bytes into an occupied slot.
+ */
+static int hashmap_iter_batch(iter_context *ctx, void **out, int n,
+        size_t offset) {
+    int count = 0;
+    hashmap_t *target = (hashmap_t*)ctx->_data;
+    if(target == NULL) {
+        ctx->status = ALC_ITER_INVALID;
+        count = -1;
+        goto done;
     }
-    if(bitmap_contains(target->_filter, ctx->index)) {
-        r = value_at(target, ctx->index);
+    size_t end = iter_end(ctx, target->capacity);
+    size_t i = bitmap_next(target->_filter, ctx->index, end);
+    for(; i < end && count < n; i = bitmap_next(target->_filter, i + 1, end)) {
+        out[count++] = slot_at(target, i, offset);
     }
+    ctx->index = i;
+    ctx->status = (i >= end) ? ALC_ITER_STOP:ALC_ITER_CONTINUE;
+done:
+    return count;
+}
 
-    if(ctx->index == target->capacity) {
-        ctx->status = ALC_ITER_STOP;
+static int hashmap_iter_keys_batch(iter_context *ctx, void **out, int n) {
+    return hashmap_iter_batch(ctx, out, n, 0);
+}
+
+static int hashmap_iter_values_batch(iter_context *ctx, void **out, int n) {
+    hashmap_t *target = (hashmap_t*)ctx->_data;
+    return hashmap_iter_batch(ctx, out, n,
+            (target == NULL) ? 0:target->val_offset);
+}
+
+static int hashmap_iter_entries_batch(iter_context *ctx, void **out, int n) {
+    hashmap_entries_iter_t *iter = (hashmap_entries_iter_t*)ctx;
+    hashmap_t *target = (hashmap_t*)ctx->_data;
+    void *keys[ALC_HASHMAP_ENTRY_BATCH];
+    if(n > ALC_HASHMAP_ENTRY_BATCH) {
+        n = ALC_HASHMAP_ENTRY_BATCH;
     }
-    else {
-        ctx->status = ALC_ITER_CONTINUE;
-        ctx->index++;
+    int count = hashmap_iter_batch(ctx, keys, n, 0);
+    for(int i = 0; i < count; i++) {
+        iter->entries[i].key = keys[i];
+        iter->entries[i].value =
+            (void**)((char*)keys[i] + target->val_offset);
+        out[i] = &iter->entries[i];
     }
-done:
-    return r;
+    return count;
+}
+
+static void **hashmap_iter_entries(iter_context *ctx) {
+    void *entry = NULL;
+    hashmap_iter_entries_batch(ctx, &entry, 1);
+    return entry;
+}
+
+static size_t hashmap_iter_limit(iter_context *ctx) {
+    hashmap_t *target = (hashmap_t*)ctx->_data;
+    return (target == NULL) ? 0:target->capacity;
 }
 
 iter_context *create_hashmap_keys_iterator(hashmap_t *target) {
-    iter_context *r = malloc(sizeof(iter_context));
+    return create_hashmap_keys_iterator_range(target, 0, ALC_ITER_END);
+}
+
+iter_context *create_hashmap_values_iterator(hashmap_t *target) {
+    return create_hashmap_values_iterator_range(target, 0, ALC_ITER_END);
+}
+
+iter_context *create_hashmap_entries_iterator(hashmap_t *target) {
+    return create_hashmap_entries_iterator_range(target, 0, ALC_ITER_END);
+}
+
+iter_context *create_hashmap_keys_iterator_range(hashmap_t *target,
+        size_t begin, size_t end) {
+    iter_context *r = NULL;
+    if(begin > end) {
+        goto done;
+    }
+    r = malloc(sizeof(iter_context));
     if(r == NULL) {
         goto done;
     }
-    r->index = 0;
-    r->status = ALC_ITER_READY;
-    r->_data = target;
-    r->next = hashmap_iter_keys;
+    iter_init_hashmap_keys(r, target);
+    r->flags &= ~ALC_ITER_STATIC;
+    r->index = begin;
+    r->end = end;
 done:
     return r;
 }
 
-iter_context *create_hashmap_values_iterator(hashmap_t *target) {
-    iter_context *r = malloc(sizeof(iter_context));
+iter_context *create_hashmap_values_iterator_range(hashmap_t *target,
+        size_t begin, size_t end) {
+    iter_context *r = NULL;
+    if(begin > end) {
+        goto done;
+    }
+    r = malloc(sizeof(iter_context));
     if(r == NULL) {
         goto done;
     }
-    r->index = 0;
-    r->status = ALC_ITER_READY;
-    r->_data = target;
-    r->next = hashmap_iter_values;
+    iter_init_hashmap_values(r, target);
+    r->flags &= ~ALC_ITER_STATIC;
+    r->index = begin;
+    r->end = end;
 done:
     return r;
 }
+
+iter_context *create_hashmap_entries_iterator_range(hashmap_t *target,
+        size_t begin, size_t end) {
+    hashmap_entries_iter_t *r = NULL;
+    if(begin > end) {
+        goto done;
+    }
+    r = malloc(sizeof(hashmap_entries_iter_t));
+    if(r == NULL) {
+        goto done;
+    }
+    iter_init_hashmap_entries(r, target);
+    r->ctx.flags &= ~ALC_ITER_STATIC;
+    r->ctx.index = begin;
+    r->ctx.end = end;
+done:
+    return (iter_context*)r;
+}
+
+/*
+ * Common initialization for every kind of hashmap iterator
+ */
+static int init_hashmap_iter(iter_context *ctx, hashmap_t *target,
+        iter_next_fn *next, iter_batch_fn *next_batch) {
+    if(ctx == NULL) {
+        return ALC_ITER_NULL;
+    }
+    ctx->index = 0;
+    ctx->end = ALC_ITER_END;
+    ctx->status = ALC_ITER_READY;
+    ctx->flags = ALC_ITER_STATIC;
+    ctx->_data = target;
+    ctx->next = next;
+    ctx->next_batch = next_batch;
+    ctx->limit = hashmap_iter_limit;
+    return (target == NULL) ? ALC_ITER_INVALID:ALC_ITER_READY;
+}
+
+int iter_init_hashmap_keys(iter_context *ctx, hashmap_t *target) {
+    return init_hashmap_iter(ctx, target,
+            hashmap_iter_keys, hashmap_iter_keys_batch);
+}
+
+int iter_init_hashmap_values(iter_context *ctx, hashmap_t *target) {
+    return init_hashmap_iter(ctx, target,
+            hashmap_iter_values, hashmap_iter_values_batch);
+}
+
+int iter_init_hashmap_entries(hashmap_entries_iter_t *iter, hashmap_t *target) {
+    if(iter == NULL) {
+        return ALC_ITER_NULL;
+    }
+    int status = init_hashmap_iter(&iter->ctx, target,
+            hashmap_iter_entries, hashmap_iter_entries_batch);
+    iter->ctx.flags |= ALC_ITER_EMBEDDED;
+    return status;
+}
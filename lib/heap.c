@@ -0,0 +1,409 @@
+#include <alibc/containers/heap.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/hashmap.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// smallest position map created for indexed heaps
+#define MIN_POSITIONS 8
+
+#define unit(self) ((self)->data->data->elem_size)
+#define elem(self, i) ((char*)array_at_unchecked((self)->data, (i)))
+// the element being sifted, and the element last removed from the top
+#define hole(self) ((char*)dynabuf_at((self)->scratch, 0))
+#define removed(self) ((char*)dynabuf_at((self)->scratch, 1))
+
+// private functions
+static int check_valid(heap_t *self);
+static heap_t *create_heap_common(array_t *data, size_t arity, cmp_type *cmp);
+static void *load(heap_t *self, char *e);
+static void store(heap_t *self, char *dest, void *item);
+static int place(heap_t *self, size_t i, char *src);
+static int settle(heap_t *self, size_t i);
+static int sift_up(heap_t *self, size_t i);
+static int sift_down(heap_t *self, size_t i);
+
+
+heap_t *create_heap(size_t size, size_t unit, size_t arity, cmp_type *cmp) {
+    heap_t *r = NULL;
+    array_t *data;
+    if(unit == 0 || arity < 2 || cmp == NULL) {
+        DBG_LOG("Invalid heap unit %zu or arity %zu\n", unit, arity);
+        goto done;
+    }
+    data = create_array(size ? size:1, unit);
+    if(data == NULL) {
+        DBG_LOG("Could not create array for heap\n");
+        goto done;
+    }
+    r = create_heap_common(data, arity, cmp);
+done:
+    return r;
+}
+
+
+heap_t *create_heap_indexed(size_t size, size_t unit, size_t arity,
+        cmp_type *cmp, hash_type *hash, cmp_type *eq) {
+    heap_t *r = NULL;
+    if(hash == NULL || eq == NULL) {
+        DBG_LOG("Indexed heaps need a hash and an equality function\n");
+        goto done;
+    }
+    r = create_heap(size, unit, arity, cmp);
+    if(r == NULL) {
+        goto done;
+    }
+    r->positions = create_hashmap(
+        size < MIN_POSITIONS ? MIN_POSITIONS:size, unit, sizeof(size_t),
+        hash, eq, NULL
+    );
+    if(r->positions == NULL) {
+        DBG_LOG("Could not create position map for heap\n");
+        heap_free(r);
+        r = NULL;
+    }
+done:
+    return r;
+}
+
+
+heap_t *create_heap_from_array(array_t *src, size_t arity, cmp_type *cmp) {
+    heap_t *r = NULL;
+    array_t *data;
+    int64_t count = array_size(src);
+    if(count < 0 || arity < 2 || cmp == NULL) {
+        DBG_LOG("Invalid source array or arity %zu\n", arity);
+        goto done;
+    }
+    data = create_array(count ? count:1, src->data->elem_size);
+    if(data == NULL || array_extend(data, src) != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("Could not copy source array for heap\n");
+        array_free(data);
+        goto done;
+    }
+    r = create_heap_common(data, arity, cmp);
+    if(r == NULL || count < 2) {
+        goto done;
+    }
+    // Floyd's construction: sift down every parent, deepest first
+    for(size_t i = (count - 2) / arity + 1; i-- > 0;) {
+        memcpy(hole(r), elem(r, i), unit(r));
+        sift_down(r, i);
+    }
+done:
+    return r;
+}
+
+
+int heap_push(heap_t *self, void *item) {
+    int status = check_valid(self);
+    if(status != ALC_HEAP_SUCCESS) {
+        goto invalid_status;
+    }
+    // append reserves the new slot, which the sift then fills
+    if(array_append(self->data, item) != ALC_ARRAY_SUCCESS) {
+        DBG_LOG("Could not grow heap\n");
+        status = ALC_HEAP_NO_MEM;
+        goto done;
+    }
+    store(self, hole(self), item);
+    status = sift_up(self, self->data->size - 1);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+void **heap_peek(heap_t *self) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_HEAP_SUCCESS) {
+        goto invalid_status;
+    }
+    if(self->data->size == 0) {
+        status = ALC_HEAP_EMPTY;
+        goto done;
+    }
+    r = (void**)elem(self, 0);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+void **heap_pop(heap_t *self) {
+    void **r = NULL;
+    size_t last;
+    int status = check_valid(self);
+    if(status != ALC_HEAP_SUCCESS) {
+        goto invalid_status;
+    }
+    if(self->data->size == 0) {
+        status = ALC_HEAP_EMPTY;
+        goto done;
+    }
+    memcpy(removed(self), elem(self, 0), unit(self));
+    if(self->positions != NULL) {
+        hashmap_remove(self->positions, load(self, removed(self)));
+    }
+    last = --self->data->size;
+    if(last > 0) {
+        memcpy(hole(self), elem(self, last), unit(self));
+        // the element in the hole never has an entry in the position map
+        if(self->positions != NULL) {
+            hashmap_remove(self->positions, load(self, hole(self)));
+        }
+        status = sift_down(self, 0);
+    }
+    r = (void**)removed(self);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+void **heap_replace_top(heap_t *self, void *item) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_HEAP_SUCCESS) {
+        goto invalid_status;
+    }
+    if(self->data->size == 0) {
+        status = ALC_HEAP_EMPTY;
+        goto done;
+    }
+    memcpy(removed(self), elem(self, 0), unit(self));
+    if(self->positions != NULL) {
+        hashmap_remove(self->positions, load(self, removed(self)));
+    }
+    store(self, hole(self), item);
+    status = sift_down(self, 0);
+    r = (void**)removed(self);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int heap_update(heap_t *self, void *old, void *item) {
+    void **found;
+    size_t index;
+    int status = check_valid(self);
+    if(status != ALC_HEAP_SUCCESS) {
+        goto invalid_status;
+    }
+    if(self->positions == NULL) {
+        DBG_LOG("Only indexed heaps can be updated\n");
+        status = ALC_HEAP_INVALID_REQ;
+        goto done;
+    }
+    found = hashmap_fetch(self->positions, old);
+    if(found == NULL) {
+        status = ALC_HEAP_NOT_FOUND;
+        goto done;
+    }
+    index = *(size_t*)found;
+    hashmap_remove(self->positions, old);
+    store(self, hole(self), item);
+    // move towards the root if the new value beats the parent, else away
+    if(index > 0 && self->cmp(load(self, hole(self)),
+            load(self, elem(self, (index - 1) / self->arity))) < 0) {
+        status = sift_up(self, index);
+    }
+    else {
+        status = sift_down(self, index);
+    }
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int64_t heap_size(heap_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_HEAP_SUCCESS) {
+        size = self->data->size;
+    }
+    return size;
+}
+
+
+void heap_free(heap_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    array_free(self->data);
+    dynabuf_free(self->scratch);
+    if(self->positions != NULL) {
+        hashmap_free(self->positions);
+    }
+    free(self);
+}
+
+
+int heap_status(heap_t *self) {
+    return (self == NULL) ? ALC_HEAP_INVALID:self->status;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(heap_t *self) {
+    int status = ALC_HEAP_SUCCESS;
+    if(self == NULL || self->data == NULL || self->scratch == NULL) {
+        status = ALC_HEAP_INVALID;
+    }
+    return status;
+}
+
+// takes ownership of data, and frees it on errors
+static heap_t *create_heap_common(array_t *data, size_t arity, cmp_type *cmp) {
+    heap_t *r = malloc(sizeof(heap_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc heap_t\n");
+        array_free(data);
+        goto done;
+    }
+    r->scratch = create_dynabuf(2, data->data->elem_size);
+    if(r->scratch == NULL) {
+        DBG_LOG("Could not create scratch buffer for heap\n");
+        array_free(data);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->data         = data;
+    r->positions    = NULL;
+    r->cmp          = cmp;
+    r->arity        = arity;
+    r->status       = ALC_HEAP_SUCCESS;
+done:
+    return r;
+}
+
+// the argument passed to comparators and hash functions for an element
+static void *load(heap_t *self, char *e) {
+    void *r = NULL;
+    if(unit(self) > sizeof(void*)) {
+        r = e;
+    }
+    else {
+        memcpy(&r, e, unit(self));
+    }
+    return r;
+}
+
+// copy an item passed by the caller into the heap's storage
+static void store(heap_t *self, char *dest, void *item) {
+    if(unit(self) > sizeof(void*)) {
+        memcpy(dest, item, unit(self));
+    }
+    else {
+        memcpy(dest, &item, unit(self));
+    }
+}
+
+/*
+ * Move an element which is already in the heap into slot i.  The position map
+ * is updated first, so that on failure the element stays where it was.
+ */
+static int place(heap_t *self, size_t i, char *src) {
+    int status = ALC_HEAP_SUCCESS;
+    if(self->positions != NULL
+            && hashmap_set(self->positions, load(self, src),
+                (void*)(uintptr_t)i) != ALC_HASHMAP_SUCCESS) {
+        DBG_LOG("Could not record heap position\n");
+        status = ALC_HEAP_NO_MEM;
+        goto done;
+    }
+    memcpy(elem(self, i), src, unit(self));
+done:
+    return status;
+}
+
+// fill slot i with the element in the hole, which is new to the position map
+static int settle(heap_t *self, size_t i) {
+    int status = ALC_HEAP_SUCCESS;
+    memcpy(elem(self, i), hole(self), unit(self));
+    if(self->positions != NULL
+            && hashmap_set(self->positions, load(self, hole(self)),
+                (void*)(uintptr_t)i) != ALC_HASHMAP_SUCCESS) {
+        DBG_LOG("Could not record heap position\n");
+        status = ALC_HEAP_NO_MEM;
+    }
+    return status;
+}
+
+/*
+ * Move the hole at slot i towards the root until the element in the hole
+ * buffer fits there, then fill it.  Parents are moved down into the hole
+ * rather than swapped with it, so each level costs one copy.  If a move fails
+ * the hole is filled where it stands, so that no element is lost.
+ */
+static int sift_up(heap_t *self, size_t i) {
+    int status = ALC_HEAP_SUCCESS;
+    int settled;
+    void *item = load(self, hole(self));
+    while(i > 0) {
+        size_t parent = (i - 1) / self->arity;
+        if(self->cmp(item, load(self, elem(self, parent))) >= 0) {
+            break;
+        }
+        if((status = place(self, i, elem(self, parent))) != ALC_HEAP_SUCCESS) {
+            break;
+        }
+        i = parent;
+    }
+    settled = settle(self, i);
+    return (status != ALC_HEAP_SUCCESS) ? status:settled;
+}
+
+/*
+ * Move the hole at slot i away from the root until the element in the hole
+ * buffer fits there, then fill it.  Failures are handled as in sift_up.
+ */
+static int sift_down(heap_t *self, size_t i) {
+    int status = ALC_HEAP_SUCCESS;
+    int settled;
+    size_t size = self->data->size;
+    size_t arity = self->arity;
+    void *item = load(self, hole(self));
+    for(;;) {
+        size_t first = arity*i + 1;
+        size_t last = first + arity;
+        size_t best = first;
+        if(first >= size) {
+            break;
+        }
+        last = (last < size) ? last:size;
+        for(size_t c = first + 1; c < last; c++) {
+            if(self->cmp(load(self, elem(self, c)),
+                    load(self, elem(self, best))) < 0) {
+                best = c;
+            }
+        }
+#if defined(__GNUC__)
+        // the next level's children are contiguous, so fetch them early
+        __builtin_prefetch(elem(self, arity*best + 1));
+#endif
+        if(self->cmp(load(self, elem(self, best)), item) >= 0) {
+            break;
+        }
+        if((status = place(self, i, elem(self, best))) != ALC_HEAP_SUCCESS) {
+            break;
+        }
+        i = best;
+    }
+    settled = settle(self, i);
+    return (status != ALC_HEAP_SUCCESS) ? status:settled;
+}
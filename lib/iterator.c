@@ -1,5 +1,6 @@
 #include <alibc/containers/iterator.h>
 #include <stddef.h>
+#include <stdlib.h>
 /*
  * Internal status-check function
  */
@@ -16,6 +17,66 @@ done:
     return next_val;
 }
 
+int iter_next_batch(iter_context *ctx, void **out, int n) {
+    int count = -1;
+    int status = check_status(ctx);
+    if(status != ALC_ITER_READY && status != ALC_ITER_CONTINUE) {
+        goto done;
+    }
+    if(out == NULL || n < 0) {
+        goto done;
+    }
+    if(ctx->next_batch != NULL) {
+        count = ctx->next_batch(ctx, out, n);
+        goto done;
+    }
+    // generic fallback, one element at a time
+    count = 0;
+    while(count < n && ctx->status != ALC_ITER_STOP) {
+        void **next_val = ctx->next(ctx);
+        if(next_val == NULL) {
+            break;
+        }
+        out[count++] = next_val;
+    }
+    if(ctx->status == ALC_ITER_INVALID) {
+        count = -1;
+    }
+done:
+    return count;
+}
+
+int iter_split(iter_context *ctx, iter_context *parts, int k) {
+    int count = -1;
+    int status = check_status(ctx);
+    if(status != ALC_ITER_READY || ctx->status == ALC_ITER_INVALID) {
+        goto done;
+    }
+    if(parts == NULL || k < 1 || ctx->limit == NULL
+            || (ctx->flags & ALC_ITER_EMBEDDED)) {
+        goto done;
+    }
+    size_t end = iter_end(ctx, ctx->limit(ctx));
+    size_t begin = (ctx->index < end) ? ctx->index:end;
+    size_t span = end - begin;
+    if(span < (size_t)k) {
+        k = span;
+    }
+    // the first span % k parts take one extra slot each
+    for(int i = 0; i < k; i++) {
+        size_t width = span / k + ((size_t)i < span % k);
+        parts[i] = *ctx;
+        parts[i].flags = ALC_ITER_STATIC;
+        parts[i].status = ALC_ITER_READY;
+        parts[i].index = begin;
+        parts[i].end = begin + width;
+        begin += width;
+    }
+    count = k;
+done:
+    return count;
+}
+
 int iter_status(iter_context *ctx) {
     if(ctx == NULL) {
         return ALC_ITER_NULL;
@@ -24,7 +85,7 @@ int iter_status(iter_context *ctx) {
 }
 
 void iter_free(iter_context *ctx) {
-    if(ctx != NULL) {
+    if(ctx != NULL && !(ctx->flags & ALC_ITER_STATIC)) {
         free(ctx);
     }
 }
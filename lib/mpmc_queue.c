@@ -0,0 +1,281 @@
+#include <alibc/containers/mpmc_queue.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sched.h>
+
+// round x up to the next multiple of a, a must be a power of two
+#define align_up(x, a) (((x) + ((a) - 1)) & ~((size_t)(a) - 1))
+// the element follows the sequence number in each cell
+#define CELL_HEADER align_up(sizeof(atomic_size_t), sizeof(void*))
+// number of busy-wait rounds before a blocking call yields the CPU
+#define SPIN_LIMIT 64
+
+// private functions
+static int check_valid(mpmc_queue_t *self);
+static atomic_size_t *cell_seq(mpmc_queue_t *self, size_t pos);
+static char *cell_data(mpmc_queue_t *self, size_t pos);
+static size_t claim(mpmc_queue_t *self, atomic_size_t *counter, size_t *pos,
+        size_t count, size_t ready);
+static void backoff(int *spins);
+
+
+mpmc_queue_t *create_mpmc_queue(size_t size, size_t unit) {
+    mpmc_queue_t *r = NULL;
+    size_t capacity = 2;
+    size_t cell_size;
+    if(unit == 0 || size == 0 || unit > SIZE_MAX / 4
+            || size > SIZE_MAX / 4 / (CELL_HEADER + unit)) {
+        DBG_LOG("Invalid queue size %zu of unit %zu\n", size, unit);
+        goto done;
+    }
+    // a single-slot ring cannot tell a full cell from an empty one
+    while(capacity < size) {
+        capacity <<= 1;
+    }
+    cell_size = align_up(CELL_HEADER + unit, sizeof(void*));
+
+    // the struct is cache line aligned, which malloc does not provide
+    if(posix_memalign((void**)&r, ALC_MPMC_QUEUE_CACHELINE,
+            sizeof(mpmc_queue_t)) != 0) {
+        r = NULL;
+        DBG_LOG("Could not allocate mpmc_queue_t\n");
+        goto done;
+    }
+    r->cells = create_dynabuf_aligned(capacity, cell_size,
+            ALC_DYNABUF_ALIGN_CACHELINE);
+    if(r->cells == NULL) {
+        DBG_LOG("Could not create dynabuf for queue\n");
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->mask         = capacity - 1;
+    r->elem_size    = unit;
+    atomic_init(&r->enqueue_pos, 0);
+    atomic_init(&r->dequeue_pos, 0);
+    for(size_t i = 0; i < capacity; i++) {
+        atomic_init(cell_seq(r, i), i);
+    }
+done:
+    return r;
+}
+
+
+int mpmc_queue_try_push(mpmc_queue_t *self, void *item) {
+    size_t pos;
+    int status = check_valid(self);
+    if(status != ALC_MPMC_QUEUE_SUCCESS) {
+        goto done;
+    }
+    if(claim(self, &self->enqueue_pos, &pos, 1, 0) == 0) {
+        status = ALC_MPMC_QUEUE_FULL;
+        goto done;
+    }
+    if(self->elem_size > sizeof(void*)) {
+        memcpy(cell_data(self, pos), item, self->elem_size);
+    }
+    else {
+        memcpy(cell_data(self, pos), &item, self->elem_size);
+    }
+    atomic_store_explicit(cell_seq(self, pos), pos + 1, memory_order_release);
+done:
+    return status;
+}
+
+
+int mpmc_queue_push(mpmc_queue_t *self, void *item) {
+    int spins = 0;
+    int status;
+    while((status = mpmc_queue_try_push(self, item)) == ALC_MPMC_QUEUE_FULL) {
+        backoff(&spins);
+    }
+    return status;
+}
+
+
+int mpmc_queue_try_pop(mpmc_queue_t *self, void *dest) {
+    size_t pos;
+    int status = check_valid(self);
+    if(status != ALC_MPMC_QUEUE_SUCCESS || dest == NULL) {
+        status = ALC_MPMC_QUEUE_INVALID;
+        goto done;
+    }
+    if(claim(self, &self->dequeue_pos, &pos, 1, 1) == 0) {
+        status = ALC_MPMC_QUEUE_EMPTY;
+        goto done;
+    }
+    memcpy(dest, cell_data(self, pos), self->elem_size);
+    // the cell is next filled by the producer one lap later
+    atomic_store_explicit(cell_seq(self, pos), pos + self->mask + 1,
+            memory_order_release);
+done:
+    return status;
+}
+
+
+int mpmc_queue_pop(mpmc_queue_t *self, void *dest) {
+    int spins = 0;
+    int status;
+    while((status = mpmc_queue_try_pop(self, dest)) == ALC_MPMC_QUEUE_EMPTY) {
+        backoff(&spins);
+    }
+    return status;
+}
+
+
+int64_t mpmc_queue_try_push_n(mpmc_queue_t *self, const void *src,
+        size_t count) {
+    int64_t r;
+    size_t pos;
+    size_t n;
+    if(check_valid(self) != ALC_MPMC_QUEUE_SUCCESS
+            || (src == NULL && count > 0)) {
+        r = ALC_MPMC_QUEUE_INVALID;
+        goto done;
+    }
+    n = claim(self, &self->enqueue_pos, &pos, count, 0);
+    for(size_t i = 0; i < n; i++) {
+        memcpy(cell_data(self, pos + i),
+                (const char*)src + i*self->elem_size, self->elem_size);
+        atomic_store_explicit(cell_seq(self, pos + i), pos + i + 1,
+                memory_order_release);
+    }
+    r = n;
+done:
+    return r;
+}
+
+
+int64_t mpmc_queue_try_pop_n(mpmc_queue_t *self, void *dest, size_t count) {
+    int64_t r;
+    size_t pos;
+    size_t n;
+    if(check_valid(self) != ALC_MPMC_QUEUE_SUCCESS
+            || (dest == NULL && count > 0)) {
+        r = ALC_MPMC_QUEUE_INVALID;
+        goto done;
+    }
+    n = claim(self, &self->dequeue_pos, &pos, count, 1);
+    for(size_t i = 0; i < n; i++) {
+        memcpy((char*)dest + i*self->elem_size, cell_data(self, pos + i),
+                self->elem_size);
+        atomic_store_explicit(cell_seq(self, pos + i), pos + i + self->mask + 1,
+                memory_order_release);
+    }
+    r = n;
+done:
+    return r;
+}
+
+
+int64_t mpmc_queue_size(mpmc_queue_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_MPMC_QUEUE_SUCCESS) {
+        size_t head = atomic_load_explicit(
+            &self->dequeue_pos, memory_order_acquire
+        );
+        size_t tail = atomic_load_explicit(
+            &self->enqueue_pos, memory_order_acquire
+        );
+        // the counters can move between the two loads, so clamp the result
+        if((intptr_t)(tail - head) < 0) {
+            size = 0;
+        }
+        else {
+            size = (tail - head > self->mask + 1) ? self->mask + 1:tail - head;
+        }
+    }
+    return size;
+}
+
+
+int64_t mpmc_queue_capacity(mpmc_queue_t *self) {
+    int64_t capacity = -1;
+    if(check_valid(self) == ALC_MPMC_QUEUE_SUCCESS) {
+        capacity = self->mask + 1;
+    }
+    return capacity;
+}
+
+
+void mpmc_queue_free(mpmc_queue_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    dynabuf_free(self->cells);
+    free(self);
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(mpmc_queue_t *self) {
+    int status = ALC_MPMC_QUEUE_SUCCESS;
+    if(self == NULL || self->cells == NULL) {
+        status = ALC_MPMC_QUEUE_INVALID;
+    }
+    return status;
+}
+
+static atomic_size_t *cell_seq(mpmc_queue_t *self, size_t pos) {
+    return (atomic_size_t*)dynabuf_at(self->cells, pos & self->mask);
+}
+
+static char *cell_data(mpmc_queue_t *self, size_t pos) {
+    return (char*)dynabuf_at(self->cells, pos & self->mask) + CELL_HEADER;
+}
+
+/*
+ * Claim up to count consecutive positions from counter.  A cell at position p
+ * is ready when its sequence is p + ready: 0 for producers looking for an
+ * empty cell, 1 for consumers looking for a full one.  Only the leading run
+ * of ready cells is claimed, with a single CAS on the counter.
+ * @return the number of positions claimed, starting at *pos.
+ */
+static size_t claim(mpmc_queue_t *self, atomic_size_t *counter, size_t *pos,
+        size_t count, size_t ready) {
+    size_t start = atomic_load_explicit(counter, memory_order_relaxed);
+    size_t seq = 0;
+    size_t n;
+    while(count > 0) {
+        for(n = 0; n < count && n <= self->mask; n++) {
+            seq = atomic_load_explicit(
+                cell_seq(self, start + n), memory_order_acquire
+            );
+            if(seq != start + n + ready) {
+                break;
+            }
+        }
+        if(n == 0) {
+            // behind by a lap: the queue is full (or empty), not contended
+            if((intptr_t)(seq - (start + ready)) < 0) {
+                break;
+            }
+            start = atomic_load_explicit(counter, memory_order_relaxed);
+            continue;
+        }
+        if(atomic_compare_exchange_weak_explicit(counter, &start, start + n,
+                memory_order_relaxed, memory_order_relaxed)) {
+            *pos = start;
+            return n;
+        }
+    }
+    return 0;
+}
+
+static void backoff(int *spins) {
+    if(*spins < SPIN_LIMIT) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+#endif
+        (*spins)++;
+    }
+    else {
+        sched_yield();
+    }
+}
@@ -0,0 +1,321 @@
+#include <alibc/containers/pool.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// round x up to the next multiple of a, a must be a power of two
+#define align_up(x, a) (((x) + ((a) - 1)) & ~((uintptr_t)(a) - 1))
+// free objects store the next free object in their first word
+#define next_free(obj) (*(void**)(obj))
+
+// private functions
+static int check_valid(pool_t *self);
+static int add_chunk(pool_t *self);
+static void *take_object(pool_t *self);
+static void put_object(pool_t *self, void *obj);
+
+
+pool_t *create_pool(size_t unit, size_t chunk_objs, int flags) {
+    pool_t *r = NULL;
+    if(unit == 0 || chunk_objs == 0) {
+        DBG_LOG("Pool objects and chunks must be non-empty\n");
+        goto done;
+    }
+
+    r = malloc(sizeof(pool_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc pool_t\n");
+        goto done;
+    }
+
+    r->align = (flags & ALC_POOL_ALIGNED) ? ALC_POOL_CACHELINE:ALC_POOL_ALIGN;
+    // every object must be able to hold a free list link
+    r->obj_size = align_up(unit < sizeof(void*) ? sizeof(void*):unit, r->align);
+    r->chunk_objs = chunk_objs;
+
+    r->chunks = create_dynabuf(1, sizeof(dynabuf_t*));
+    if(r->chunks == NULL) {
+        DBG_LOG("Could not create chunk table for pool\n");
+        free(r);
+        r = NULL;
+        goto done;
+    }
+
+    r->lock = NULL;
+    if(flags & ALC_POOL_SHARED) {
+        r->lock = malloc(sizeof(pthread_mutex_t));
+        if(r->lock == NULL || pthread_mutex_init(r->lock, NULL) != 0) {
+            DBG_LOG("Could not create lock for shared pool\n");
+            free(r->lock);
+            dynabuf_free(r->chunks);
+            free(r);
+            r = NULL;
+            goto done;
+        }
+    }
+
+    r->free_list    = NULL;
+    r->carve        = NULL;
+    r->carve_end    = NULL;
+    r->nchunks      = 0;
+    r->live         = 0;
+    r->status       = ALC_POOL_SUCCESS;
+done:
+    return r;
+}
+
+
+void *pool_alloc(pool_t *self) {
+    void *r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_POOL_SUCCESS) {
+        DBG_LOG("Pool was invalid on alloc operation\n");
+        goto invalid_status;
+    }
+
+    if(self->lock != NULL) {
+        pthread_mutex_lock(self->lock);
+    }
+    r = take_object(self);
+    if(self->lock != NULL) {
+        pthread_mutex_unlock(self->lock);
+    }
+invalid_status:
+    return r;
+}
+
+
+int pool_release(pool_t *self, void *obj) {
+    int status = check_valid(self);
+    if(status != ALC_POOL_SUCCESS) {
+        DBG_LOG("Pool was invalid on release operation\n");
+        goto invalid_status;
+    }
+
+    // the status is shared with other threads, so it is only written locked
+    if(self->lock != NULL) {
+        pthread_mutex_lock(self->lock);
+    }
+    if(obj == NULL) {
+        status = ALC_POOL_INVALID_REQ;
+        goto done;
+    }
+    put_object(self, obj);
+done:
+    self->status = status;
+    if(self->lock != NULL) {
+        pthread_mutex_unlock(self->lock);
+    }
+invalid_status:
+    return status;
+}
+
+
+int64_t pool_size(pool_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_POOL_SUCCESS) {
+        size = self->live;
+    }
+    return size;
+}
+
+
+void pool_free(pool_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    if(self->chunks != NULL) {
+        for(size_t i = 0; i < self->nchunks; i++) {
+            dynabuf_free(*(dynabuf_t**)dynabuf_fetch(self->chunks, i));
+        }
+        dynabuf_free(self->chunks);
+    }
+    if(self->lock != NULL) {
+        pthread_mutex_destroy(self->lock);
+        free(self->lock);
+    }
+    free(self);
+}
+
+
+int pool_status(pool_t *self) {
+    return (self == NULL) ? ALC_POOL_INVALID:self->status;
+}
+
+
+int pool_cache_init(pool_cache_t *cache, pool_t *pool, int limit) {
+    int status = check_valid(pool);
+    if(cache == NULL || status != ALC_POOL_SUCCESS) {
+        status = ALC_POOL_INVALID;
+        goto done;
+    }
+    if(pool->lock == NULL || limit < 1) {
+        DBG_LOG("Per-thread caches require a shared pool\n");
+        status = ALC_POOL_INVALID_REQ;
+        goto done;
+    }
+    cache->pool         = pool;
+    cache->free_list    = NULL;
+    cache->count        = 0;
+    cache->limit        = limit;
+done:
+    return status;
+}
+
+
+void *pool_cache_alloc(pool_cache_t *cache) {
+    void *r = NULL;
+    if(cache == NULL || check_valid(cache->pool) != ALC_POOL_SUCCESS) {
+        goto done;
+    }
+
+    if(cache->free_list == NULL) {
+        // refill half of the cache under a single lock acquisition
+        int refill = (cache->limit + 1) / 2;
+        pthread_mutex_lock(cache->pool->lock);
+        for(int i = 0; i < refill; i++) {
+            void *obj = take_object(cache->pool);
+            if(obj == NULL) {
+                break;
+            }
+            next_free(obj) = cache->free_list;
+            cache->free_list = obj;
+            cache->count++;
+        }
+        pthread_mutex_unlock(cache->pool->lock);
+    }
+
+    r = cache->free_list;
+    if(r != NULL) {
+        cache->free_list = next_free(r);
+        cache->count--;
+    }
+done:
+    return r;
+}
+
+
+int pool_cache_release(pool_cache_t *cache, void *obj) {
+    int status = ALC_POOL_SUCCESS;
+    if(cache == NULL || check_valid(cache->pool) != ALC_POOL_SUCCESS) {
+        status = ALC_POOL_INVALID;
+        goto done;
+    }
+    if(obj == NULL) {
+        status = ALC_POOL_INVALID_REQ;
+        goto done;
+    }
+
+    next_free(obj) = cache->free_list;
+    cache->free_list = obj;
+    cache->count++;
+
+    if(cache->count > cache->limit) {
+        // return half of the cache under a single lock acquisition
+        int drain = cache->count / 2;
+        pthread_mutex_lock(cache->pool->lock);
+        for(int i = 0; i < drain; i++) {
+            void *victim = cache->free_list;
+            cache->free_list = next_free(victim);
+            put_object(cache->pool, victim);
+        }
+        pthread_mutex_unlock(cache->pool->lock);
+        cache->count -= drain;
+    }
+done:
+    return status;
+}
+
+
+void pool_cache_flush(pool_cache_t *cache) {
+    if(cache == NULL || check_valid(cache->pool) != ALC_POOL_SUCCESS) {
+        return;
+    }
+    pthread_mutex_lock(cache->pool->lock);
+    while(cache->free_list != NULL) {
+        void *victim = cache->free_list;
+        cache->free_list = next_free(victim);
+        put_object(cache->pool, victim);
+    }
+    pthread_mutex_unlock(cache->pool->lock);
+    cache->count = 0;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(pool_t *self) {
+    int status = ALC_POOL_SUCCESS;
+    if(self == NULL) {
+        status = ALC_POOL_INVALID;
+        goto done;
+    }
+    if(self->chunks == NULL) {
+        status = ALC_POOL_INVALID;
+        goto done;
+    }
+done:
+    return status;
+}
+
+// must be called with the pool lock held, if there is one
+static void *take_object(pool_t *self) {
+    void *r = NULL;
+    if(self->free_list != NULL) {
+        r = self->free_list;
+        self->free_list = next_free(r);
+    }
+    else {
+        if(self->carve == self->carve_end
+                && add_chunk(self) != ALC_POOL_SUCCESS) {
+            DBG_LOG("Could not add chunk to pool\n");
+            self->status = ALC_POOL_NO_MEM;
+            goto done;
+        }
+        r = self->carve;
+        self->carve += self->obj_size;
+    }
+    self->live++;
+    self->status = ALC_POOL_SUCCESS;
+done:
+    return r;
+}
+
+// must be called with the pool lock held, if there is one
+static void put_object(pool_t *self, void *obj) {
+    next_free(obj) = self->free_list;
+    self->free_list = obj;
+    self->live--;
+}
+
+static int add_chunk(pool_t *self) {
+    int status = ALC_POOL_SUCCESS;
+    dynabuf_t *chunk = create_dynabuf_aligned(
+        self->chunk_objs, self->obj_size, self->align
+    );
+    if(chunk == NULL) {
+        status = ALC_POOL_NO_MEM;
+        goto done;
+    }
+
+    if((self->nchunks + 1) * sizeof(dynabuf_t*) > self->chunks->capacity) {
+        if(dynabuf_resize(self->chunks,
+                dynabuf_grow_count(self->chunks, self->nchunks + 1))
+                != ALC_DYNABUF_SUCCESS) {
+            DBG_LOG("Could not grow pool chunk table\n");
+            dynabuf_free(chunk);
+            status = ALC_POOL_NO_MEM;
+            goto done;
+        }
+    }
+    dynabuf_set(self->chunks, self->nchunks++, chunk);
+
+    self->carve     = chunk->buf;
+    self->carve_end = self->carve + self->chunk_objs*self->obj_size;
+done:
+    return status;
+}
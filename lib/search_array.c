@@ -0,0 +1,179 @@
+#include <alibc/containers/search_array.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// the tree is prefetched this many levels ahead; the 16 descendants of an
+// element four levels down are contiguous.
+#define PREFETCH_LEVELS 4
+
+#if defined(__GNUC__)
+#define prefetch(addr) __builtin_prefetch(addr)
+#define trailing_ones(x) ((size_t)__builtin_ctzll(~(unsigned long long)(x)))
+#else
+#define prefetch(addr) ((void)(addr))
+static size_t trailing_ones(size_t x) {
+    size_t n = 0;
+    for(; x & 1; x >>= 1) {
+        n++;
+    }
+    return n;
+}
+#endif
+
+// private functions
+static int check_valid(search_array_t *self);
+static size_t fill(search_array_t *self, array_t *sorted, size_t next,
+        size_t k);
+static size_t lower_bound(search_array_t *self, void *key);
+static inline void *load(search_array_t *self, size_t k);
+
+
+search_array_t *create_search_array(array_t *sorted, cmp_type *cmp) {
+    search_array_t *r = NULL;
+    int64_t size = array_size(sorted);
+    if(size < 0 || cmp == NULL) {
+        DBG_LOG("Invalid source array or comparator for search_array\n");
+        goto done;
+    }
+    r = malloc(sizeof(search_array_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc search_array_t\n");
+        goto done;
+    }
+    r->data = create_dynabuf_aligned(
+        size + 1, sorted->data->elem_size, ALC_DYNABUF_ALIGN_CACHELINE
+    );
+    if(r->data == NULL) {
+        DBG_LOG("Could not create dynabuf for search_array\n");
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->size     = size;
+    r->cmp      = cmp;
+    r->status   = ALC_SEARCH_ARRAY_SUCCESS;
+    fill(r, sorted, 0, 1);
+done:
+    return r;
+}
+
+
+void **search_array_find(search_array_t *self, void *key) {
+    void **r = NULL;
+    size_t k;
+    int status = check_valid(self);
+    if(status != ALC_SEARCH_ARRAY_SUCCESS) {
+        DBG_LOG("search_array was invalid on find operation\n");
+        goto invalid_status;
+    }
+    k = lower_bound(self, key);
+    if(k == 0 || self->cmp(load(self, k), key) != 0) {
+        status = ALC_SEARCH_ARRAY_NOT_FOUND;
+        goto done;
+    }
+    r = dynabuf_at(self->data, k);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+void **search_array_lower_bound(search_array_t *self, void *key) {
+    void **r = NULL;
+    size_t k;
+    int status = check_valid(self);
+    if(status != ALC_SEARCH_ARRAY_SUCCESS) {
+        DBG_LOG("search_array was invalid on lower_bound operation\n");
+        goto invalid_status;
+    }
+    k = lower_bound(self, key);
+    if(k == 0) {
+        status = ALC_SEARCH_ARRAY_NOT_FOUND;
+        goto done;
+    }
+    r = dynabuf_at(self->data, k);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int64_t search_array_size(search_array_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_SEARCH_ARRAY_SUCCESS) {
+        size = self->size;
+    }
+    return size;
+}
+
+
+void search_array_free(search_array_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    dynabuf_free(self->data);
+    free(self);
+}
+
+
+int search_array_status(search_array_t *self) {
+    return (self == NULL) ? ALC_SEARCH_ARRAY_INVALID:self->status;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(search_array_t *self) {
+    int status = ALC_SEARCH_ARRAY_SUCCESS;
+    if(self == NULL || self->data == NULL || self->cmp == NULL) {
+        status = ALC_SEARCH_ARRAY_INVALID;
+    }
+    return status;
+}
+
+// element k of the tree, passed the same way as to cmp
+static inline void *load(search_array_t *self, size_t k) {
+    uintptr_t value = 0;
+    char *elem = (char*)dynabuf_at(self->data, k);
+    if(self->data->elem_size > sizeof(void*)) {
+        return elem;
+    }
+    memcpy(&value, elem, self->data->elem_size);
+    return (void*)value;
+}
+
+// in-order walk of the tree rooted at k, assigning sorted elements from next
+// onwards.  Returns the next unassigned sorted element.
+static size_t fill(search_array_t *self, array_t *sorted, size_t next,
+        size_t k) {
+    if(k <= self->size) {
+        next = fill(self, sorted, next, 2*k);
+        memcpy(dynabuf_at(self->data, k), array_at_unchecked(sorted, next),
+                self->data->elem_size);
+        next = fill(self, sorted, next + 1, 2*k + 1);
+    }
+    return next;
+}
+
+// index of the lower bound in the tree, or 0 if there is none
+static size_t lower_bound(search_array_t *self, void *key) {
+    size_t k = 1;
+    size_t ahead = (size_t)1 << PREFETCH_LEVELS;
+    while(k <= self->size) {
+        if(k <= self->size / ahead) {
+            prefetch(dynabuf_at(self->data, k*ahead));
+        }
+        // descend right while the element is less than key
+        k = 2*k + (self->cmp(load(self, k), key) < 0);
+    }
+    // undo the right turns taken after the last left turn, and that left turn
+    k >>= trailing_ones(k) + 1;
+    return k;
+}
@@ -5,13 +5,14 @@
 #include <string.h>
 
 // private functions
-static int rehash(set_t *self, int count);
+static int rehash(set_t *self, size_t count);
 static int check_valid(set_t *self);
-static int check_space_available(set_t *self, int size);
-static int set_locate(set_t *self, void *item);
-static inline bool default_load(int, int);
+static int check_space_available(set_t *self, size_t size);
+static int64_t set_locate(set_t *self, void *item);
+static inline bool default_load(size_t, size_t);
+static dynabuf_t *create_table(size_t count, size_t unit);
 
-set_t *create_set(int size, int unit, hash_type *hashfn,
+set_t *create_set(size_t size, size_t unit, hash_type *hashfn,
         cmp_type *comparefn, load_type *loadfn) {
     set_t *r = malloc(sizeof(set_t));
     if(r == NULL) {
@@ -20,7 +21,7 @@ set_t *create_set(int size, int unit, hash_type *hashfn,
         goto done;
     }
     
-    r->buf = create_dynabuf(size, unit);
+    r->buf = create_table(size, unit);
     if(r->buf == NULL) {
         DBG_LOG("Could not malloc backing buffer for set\n");
         free(r);
@@ -54,7 +55,7 @@ done:
     return r;
 }
 
-static int rehash(set_t *self, int count) {
+static int rehash(set_t *self, size_t count) {
     int status = ALC_SET_INVALID;
     if(check_valid(self) != ALC_SET_SUCCESS) {
         goto done;
@@ -68,36 +69,33 @@ static int rehash(set_t *self, int count) {
     dynabuf_t *scratch_buf;
     dynabuf_t *scratch_filter;
 
-    scratch_buf = create_dynabuf(count, self->buf->elem_size);
+    scratch_buf = create_table(count, self->buf->elem_size);
     if(scratch_buf == NULL) {
-        DBG_LOG("Could not create new backing array with size %d\n",
+        DBG_LOG("Could not create new backing array with size %zu\n",
                 self->capacity);
         status = ALC_SET_NO_MEM;
         goto done;
     }
     scratch_filter = create_bitmap(count);
     if(scratch_filter == NULL) {
-        DBG_LOG("Could not create new bitmap with size %d\n",
+        DBG_LOG("Could not create new bitmap with size %zu\n",
                 self->capacity);
-        bitmap_free(scratch_filter);
+        dynabuf_free(scratch_buf);
         status = ALC_SET_NO_MEM;
         goto done;
     }
 
-    memset(scratch_buf->buf, 0, sizeof(void*)*count);
-    memset(scratch_filter->buf, 0, count >> 3);
-
-    for(int i = 0; i < self->capacity; i++) {
+    for(size_t i = 0; i < self->capacity; i++) {
         if(!bitmap_contains(self->_filter, i)) {
             continue;
         }
         
         void **temp_item = dynabuf_fetch(self->buf,i);
         uint32_t hash = self->hash(*temp_item);
-        int index = hash % count;
+        size_t index = hash % count;
 
         while(bitmap_contains(scratch_filter, index)) {
-            index = (index + 1) % self->capacity;
+            index = (index + 1) % count;
         }
         dynabuf_set(scratch_buf, index, *temp_item);
         bitmap_add(scratch_filter, index);
@@ -140,7 +138,7 @@ int set_add(set_t *self, void *item) {
     }
 
     uint32_t hash = self->hash(item);
-    int index = hash % self->capacity;
+    size_t index = hash % self->capacity;
 
     // loop until we find an open spot to insert into
     while(bitmap_contains(self->_filter, index)) {
@@ -176,7 +174,7 @@ void **set_remove(set_t *self, void *item) {
         goto done;
     }
 
-    int index = set_locate(self, item);
+    int64_t index = set_locate(self, item);
 
     if(index != -1) {
         bitmap_remove(self->_filter, index);
@@ -192,7 +190,7 @@ done:
     return r;
 }
 
-int set_resize(set_t *self, int count) {
+int set_resize(set_t *self, size_t count) {
     int status = ALC_SET_SUCCESS;
     if(check_valid(self) != ALC_SET_SUCCESS) {
         status = ALC_SET_INVALID;
@@ -202,14 +200,14 @@ int set_resize(set_t *self, int count) {
     if(count > self->entries) {
         status = rehash(self, count);
         if(status != ALC_SET_SUCCESS) {
-            DBG_LOG("Could not rehash to new size %d\n", count);
+            DBG_LOG("Could not rehash to new size %zu\n", count);
             status = ALC_SET_NO_MEM;
             goto done;
 
         }
     }
     else if(count < self->entries) {
-        DBG_LOG("Requested count %d was too small.\n", count);
+        DBG_LOG("Requested count %zu was too small.\n", count);
         status = ALC_SET_INVALID_REQ;
         goto done;
     }
@@ -227,7 +225,7 @@ int set_contains(set_t *self, void *item) {
         goto done;
     }
 
-    int index = set_locate(self, item);
+    int64_t index = set_locate(self, item);
     if(index != -1) {
         self->status = ALC_SET_SUCCESS;
         r = 1;
@@ -241,8 +239,8 @@ done:
 }
 
 
-int set_size(set_t *self){
-    int r = -1;
+int64_t set_size(set_t *self){
+    int64_t r = -1;
     if(check_valid(self) != ALC_SET_SUCCESS) {
         goto done;
     }
@@ -314,11 +312,11 @@ done:
 }
 
 
-int check_space_available(set_t *self, int size)  {
+int check_space_available(set_t *self, size_t size)  {
     int status = ALC_SET_NO_MEM;
     switch((status = check_valid(self))) {
         case ALC_SET_SUCCESS:
-            status = (self->capacity - (self->entries + size) > 0) ? 
+            status = (self->entries + size < self->capacity) ?
                     ALC_SET_SUCCESS:ALC_SET_NO_MEM;
         break;
         default:
@@ -327,10 +325,10 @@ int check_space_available(set_t *self, int size)  {
     return status;
 }
 
-static int set_locate(set_t *self, void *item) {
+static int64_t set_locate(set_t *self, void *item) {
     uint32_t hash = self->hash(item);
-    int index = hash % self->capacity;
-    int start_index = index;
+    size_t index = hash % self->capacity;
+    size_t start_index = index;
     bool     is_valid    = 0;
     bool     is_equal    = 0;
     while(!is_equal || !is_valid) {
@@ -368,8 +366,7 @@ static int set_locate(set_t *self, void *item) {
 
         index = (index + 1) % self->capacity;
         if(index == start_index) {
-            index = -1;
-            break;
+            return -1;
         }
     }
     return index;
@@ -378,6 +375,15 @@ static int set_locate(set_t *self, void *item) {
 /*
  * 75% load by default. Chosen arbitrarily
  */
-inline bool default_load(int entries, int capacity)  {
-    return ((float)entries)/((float)capacity) > 0.75f;
+inline bool default_load(size_t entries, size_t capacity)  {
+    return ((double)entries)/((double)capacity) > 0.75;
+}
+
+// large tables are huge page aligned, as in hashmap.c
+static dynabuf_t *create_table(size_t count, size_t unit) {
+    size_t align = 0;
+    if(unit != 0 && count >= ALC_DYNABUF_HUGE_THRESHOLD / unit) {
+        align = ALC_DYNABUF_ALIGN_HUGE;
+    }
+    return create_dynabuf_aligned(count, unit, align);
 }
@@ -1,5 +1,5 @@
 #include <alibc/containers/set.h>
-#include <alibc/containers/iterator.h>
+#include <alibc/containers/set_iterator.h>
 #include <alibc/containers/dynabuf.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -11,34 +11,77 @@ static void **set_iter_next(iter_context *ctx) {
         ctx->status = ALC_ITER_INVALID;
         goto done;
     }
-    while(ctx->index < target->capacity
-       && !bitmap_contains(target->_filter, ctx->index)) {
+    size_t end = iter_end(ctx, target->capacity);
+    ctx->index = bitmap_next(target->_filter, ctx->index, end);
+    if(ctx->index < end) {
+        r = dynabuf_fetch(target->buf, ctx->index);
+        ctx->status = ALC_ITER_CONTINUE;
         ctx->index++;
     }
-    if(bitmap_contains(target->_filter, ctx->index)) {
-        r = dynabuf_fetch(target->buf, ctx->index);
+    else {
+        ctx->status = ALC_ITER_STOP;
     }
+done:
+    return r;
+}
 
-    if(ctx->index == target->capacity) {
-        ctx->status = ALC_ITER_STOP;
+static int set_iter_batch(iter_context *ctx, void **out, int n) {
+    int count = 0;
+    set_t *target = (set_t*)ctx->_data;
+    if(target == NULL) {
+        ctx->status = ALC_ITER_INVALID;
+        count = -1;
+        goto done;
     }
-    else {
-        ctx->status = ALC_ITER_CONTINUE;
-        ctx->index++;
+    size_t end = iter_end(ctx, target->capacity);
+    size_t i = bitmap_next(target->_filter, ctx->index, end);
+    for(; i < end && count < n; i = bitmap_next(target->_filter, i + 1, end)) {
+        out[count++] = dynabuf_at(target->buf, i);
     }
+    ctx->index = i;
+    ctx->status = (i >= end) ? ALC_ITER_STOP:ALC_ITER_CONTINUE;
 done:
-    return r;
+    return count;
+}
+
+static size_t set_iter_limit(iter_context *ctx) {
+    set_t *target = (set_t*)ctx->_data;
+    return (target == NULL) ? 0:target->capacity;
 }
 
 iter_context *create_set_iterator(set_t *target) {
-    iter_context *r = malloc(sizeof(iter_context));
+    return create_set_iterator_range(target, 0, ALC_ITER_END);
+}
+
+iter_context *create_set_iterator_range(set_t *target, size_t begin,
+        size_t end) {
+    iter_context *r = NULL;
+    if(begin > end) {
+        goto done;
+    }
+    r = malloc(sizeof(iter_context));
     if(r == NULL) {
         goto done;
     }
-    r->index = 0;
-    r->status = ALC_ITER_READY;
-    r->_data = target;
-    r->next = set_iter_next;
+    iter_init_set(r, target);
+    r->flags &= ~ALC_ITER_STATIC;
+    r->index = begin;
+    r->end = end;
 done:
     return r;
 }
+
+int iter_init_set(iter_context *ctx, set_t *target) {
+    if(ctx == NULL) {
+        return ALC_ITER_NULL;
+    }
+    ctx->index = 0;
+    ctx->end = ALC_ITER_END;
+    ctx->status = ALC_ITER_READY;
+    ctx->flags = ALC_ITER_STATIC;
+    ctx->_data = target;
+    ctx->next = set_iter_next;
+    ctx->next_batch = set_iter_batch;
+    ctx->limit = set_iter_limit;
+    return (target == NULL) ? ALC_ITER_INVALID:ALC_ITER_READY;
+}
@@ -0,0 +1,210 @@
+#include <alibc/containers/small_array.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// private functions
+static int check_valid(small_array_t*);
+static int reserve(small_array_t*, size_t);
+static void swap_items(small_array_t*, size_t, size_t);
+
+small_array_t *create_small_array(size_t size, size_t unit) {
+    small_array_t *r = NULL;
+    if(unit == 0 || size > (SIZE_MAX - sizeof(small_array_t)) / unit) {
+        DBG_LOG("Invalid small_array size %zu of unit %zu\n", size, unit);
+        goto done;
+    }
+    r = malloc(sizeof(small_array_t) + size*unit);
+    if(r == NULL) {
+        DBG_LOG("Could not malloc small_array_t\n");
+        goto done;
+    }
+    dynabuf_init(&r->data, r->_inline, size, unit);
+    r->size     = 0;
+    r->status   = ALC_SMALL_ARRAY_SUCCESS;
+done:
+    return r;
+}
+
+
+int small_array_insert(small_array_t *self, size_t where, void *item) {
+    int status = check_valid(self);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        DBG_LOG("Array state was invalid on insert operation\n");
+        goto invalid_status;
+    }
+    if(where > self->size) {
+        DBG_LOG("Attempted insert beyond end of array.\n");
+        status = ALC_SMALL_ARRAY_IDX_OOB;
+        goto done;
+    }
+    status = reserve(self, 1);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        DBG_LOG("No space to insert new item. Ignoring.\n");
+        goto done;
+    }
+    // place the displaced object just past the end of the array
+    swap_items(self, where, self->size);
+    dynabuf_set(&self->data, where, item);
+    self->size++;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int small_array_append(small_array_t *self, void *item) {
+    int status = check_valid(self);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        DBG_LOG("Array state was invalid on append operation\n");
+        goto invalid_status;
+    }
+    status = reserve(self, 1);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        DBG_LOG("No space to append new item. Ignoring.\n");
+        goto done;
+    }
+    dynabuf_set(&self->data, self->size++, item);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+void **small_array_fetch(small_array_t *self, size_t which) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        DBG_LOG("Array state was invalid on fetch operation\n");
+        goto invalid_status;
+    }
+    if(which >= self->size) {
+        DBG_LOG("Requested fetch index was out of bounds: %zu\n", which);
+        status = ALC_SMALL_ARRAY_IDX_OOB;
+        goto done;
+    }
+    r = small_array_at_unchecked(self, which);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+void **small_array_remove(small_array_t *self, size_t which) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        DBG_LOG("Array state was invalid on remove operation\n");
+        goto invalid_status;
+    }
+    if(which >= self->size) {
+        DBG_LOG("Requested remove index was out of bounds: %zu\n", which);
+        status = ALC_SMALL_ARRAY_IDX_OOB;
+        goto done;
+    }
+    // swap in the last valid item, the removed item ends up past the end
+    swap_items(self, which, self->size - 1);
+    self->size--;
+    r = small_array_at_unchecked(self, self->size);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int small_array_resize(small_array_t *self, size_t count) {
+    int status = check_valid(self);
+    if(status != ALC_SMALL_ARRAY_SUCCESS) {
+        goto invalid_status;
+    }
+    if(count <= self->data.capacity/self->data.elem_size) {
+        // already large enough
+        goto done;
+    }
+    if(dynabuf_resize(&self->data, count) != ALC_DYNABUF_SUCCESS) {
+        DBG_LOG("Could not resize small_array backing buffer.\n");
+        status = ALC_SMALL_ARRAY_NO_MEM;
+    }
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+bool small_array_is_inline(small_array_t *self) {
+    return self != NULL && self->data.mode == ALC_DYNABUF_BORROWED;
+}
+
+
+int64_t small_array_size(small_array_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_SMALL_ARRAY_SUCCESS) {
+        size = self->size;
+    }
+    return size;
+}
+
+
+void small_array_free(small_array_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    dynabuf_release(&self->data);
+    free(self);
+}
+
+
+int small_array_status(small_array_t *self) {
+    return (self == NULL) ? ALC_SMALL_ARRAY_INVALID:self->status;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(small_array_t *self) {
+    int status = ALC_SMALL_ARRAY_SUCCESS;
+    if(self == NULL || self->data.buf == NULL) {
+        status = ALC_SMALL_ARRAY_INVALID;
+    }
+    return status;
+}
+
+// make room for count more elements, growing geometrically
+static int reserve(small_array_t *self, size_t count) {
+    int status = ALC_SMALL_ARRAY_SUCCESS;
+    size_t capacity = self->data.capacity/self->data.elem_size;
+    if(count > SIZE_MAX - self->size) {
+        status = ALC_SMALL_ARRAY_NO_MEM;
+        goto done;
+    }
+    if(self->size + count > capacity) {
+        status = small_array_resize(
+            self, dynabuf_grow_count(&self->data, self->size + count)
+        );
+    }
+done:
+    return status;
+}
+
+// exchange two elements in place, which may be one past the end of the array
+static void swap_items(small_array_t *self, size_t first, size_t second) {
+    char *a = (char*)small_array_at_unchecked(self, first);
+    char *b = (char*)small_array_at_unchecked(self, second);
+    if(a == b) {
+        return;
+    }
+    for(size_t i = 0; i < self->data.elem_size; i++) {
+        char tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
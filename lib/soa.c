@@ -0,0 +1,255 @@
+#include <alibc/containers/soa.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// private functions
+static int check_valid(soa_t *self);
+static int reserve(soa_t *self, size_t count);
+
+
+soa_t *create_soa(size_t size, const size_t *field_sizes, size_t nfields) {
+    soa_t *r = NULL;
+    if(field_sizes == NULL || nfields == 0
+            || nfields > (SIZE_MAX - sizeof(soa_t)) / sizeof(dynabuf_t*)) {
+        DBG_LOG("Invalid field list for soa\n");
+        goto done;
+    }
+    for(size_t i = 0; i < nfields; i++) {
+        if(field_sizes[i] == 0) {
+            DBG_LOG("Field %zu of soa is empty\n", i);
+            goto done;
+        }
+    }
+    size = size ? size:1;
+
+    r = malloc(sizeof(soa_t) + nfields*sizeof(dynabuf_t*));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc soa_t\n");
+        goto done;
+    }
+    for(size_t i = 0; i < nfields; i++) {
+        r->columns[i] = create_dynabuf_aligned(
+            size, field_sizes[i], ALC_DYNABUF_ALIGN_CACHELINE
+        );
+        if(r->columns[i] == NULL) {
+            DBG_LOG("Could not create column %zu of soa\n", i);
+            while(i-- > 0) {
+                dynabuf_free(r->columns[i]);
+            }
+            free(r);
+            r = NULL;
+            goto done;
+        }
+    }
+    r->nfields  = nfields;
+    r->size     = 0;
+    r->capacity = size;
+    r->status   = ALC_SOA_SUCCESS;
+done:
+    return r;
+}
+
+
+int soa_append(soa_t *self, void **fields) {
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(fields == NULL) {
+        status = ALC_SOA_INVALID;
+        goto done;
+    }
+    if(self->size == self->capacity) {
+        status = reserve(self,
+                dynabuf_grow_count(self->columns[0], self->size + 1));
+        if(status != ALC_SOA_SUCCESS) {
+            goto done;
+        }
+    }
+    for(size_t i = 0; i < self->nfields; i++) {
+        dynabuf_set(self->columns[i], self->size, fields[i]);
+    }
+    self->size++;
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int soa_set(soa_t *self, size_t row, size_t field, void *item) {
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(row >= self->size || field >= self->nfields) {
+        status = ALC_SOA_IDX_OOB;
+        goto done;
+    }
+    dynabuf_set(self->columns[field], row, item);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+void **soa_fetch(soa_t *self, size_t row, size_t field) {
+    void **r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(row >= self->size || field >= self->nfields) {
+        status = ALC_SOA_IDX_OOB;
+        goto done;
+    }
+    r = dynabuf_at(self->columns[field], row);
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int soa_fetch_row(soa_t *self, size_t row, void ***out) {
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(out == NULL) {
+        status = ALC_SOA_INVALID;
+        goto done;
+    }
+    if(row >= self->size) {
+        status = ALC_SOA_IDX_OOB;
+        goto done;
+    }
+    for(size_t i = 0; i < self->nfields; i++) {
+        out[i] = dynabuf_at(self->columns[i], row);
+    }
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int soa_remove(soa_t *self, size_t row) {
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(row >= self->size) {
+        status = ALC_SOA_IDX_OOB;
+        goto done;
+    }
+    self->size--;
+    if(row != self->size) {
+        for(size_t i = 0; i < self->nfields; i++) {
+            dynabuf_t *column = self->columns[i];
+            memcpy(dynabuf_at(column, row), dynabuf_at(column, self->size),
+                    column->elem_size);
+        }
+    }
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+void *soa_column(soa_t *self, size_t field) {
+    void *r = NULL;
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(field >= self->nfields) {
+        status = ALC_SOA_IDX_OOB;
+        goto done;
+    }
+    r = self->columns[field]->buf;
+done:
+    self->status = status;
+invalid_status:
+    return r;
+}
+
+
+int soa_resize(soa_t *self, size_t count) {
+    int status = check_valid(self);
+    if(status != ALC_SOA_SUCCESS) {
+        goto invalid_status;
+    }
+    if(count > self->capacity) {
+        status = reserve(self, count);
+    }
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int64_t soa_size(soa_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_SOA_SUCCESS) {
+        size = self->size;
+    }
+    return size;
+}
+
+
+void soa_free(soa_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    for(size_t i = 0; i < self->nfields; i++) {
+        dynabuf_free(self->columns[i]);
+    }
+    free(self);
+}
+
+
+int soa_status(soa_t *self) {
+    return (self == NULL) ? ALC_SOA_INVALID:self->status;
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(soa_t *self) {
+    int status = ALC_SOA_SUCCESS;
+    if(self == NULL || self->nfields == 0) {
+        status = ALC_SOA_INVALID;
+    }
+    return status;
+}
+
+/*
+ * Grow every column to count rows.  Columns which were grown before a
+ * failure keep their new size, which is harmless since capacity only
+ * advances once every column has room.
+ */
+static int reserve(soa_t *self, size_t count) {
+    int status = ALC_SOA_SUCCESS;
+    for(size_t i = 0; i < self->nfields; i++) {
+        dynabuf_t *column = self->columns[i];
+        if(count <= column->capacity / column->elem_size) {
+            continue;
+        }
+        if(dynabuf_resize(column, count) != ALC_DYNABUF_SUCCESS) {
+            DBG_LOG("Could not grow column %zu of soa\n", i);
+            status = ALC_SOA_NO_MEM;
+            goto done;
+        }
+    }
+    self->capacity = count;
+done:
+    return status;
+}
@@ -0,0 +1,211 @@
+#include <alibc/containers/spsc_ring.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// private functions
+static int check_valid(spsc_ring_t *self);
+static void copy_in(spsc_ring_t *self, size_t at, const char *src,
+        size_t count);
+static void copy_out(spsc_ring_t *self, size_t at, char *dest, size_t count);
+
+
+spsc_ring_t *create_spsc_ring(size_t size, size_t unit) {
+    spsc_ring_t *r = NULL;
+    size_t capacity = 1;
+    if(unit == 0 || size == 0 || size > SIZE_MAX / 2 / unit) {
+        DBG_LOG("Invalid ring size %zu of unit %zu\n", size, unit);
+        goto done;
+    }
+    while(capacity < size) {
+        capacity <<= 1;
+    }
+    // the struct is cache line aligned, which malloc does not provide
+    if(posix_memalign((void**)&r, ALC_SPSC_RING_CACHELINE,
+            sizeof(spsc_ring_t)) != 0) {
+        r = NULL;
+        DBG_LOG("Could not allocate spsc_ring_t\n");
+        goto done;
+    }
+    r->buf = create_dynabuf_aligned(capacity, unit,
+            ALC_DYNABUF_ALIGN_CACHELINE);
+    if(r->buf == NULL) {
+        DBG_LOG("Could not create dynabuf for ring\n");
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->cached_head  = 0;
+    r->cached_tail  = 0;
+    r->mask         = capacity - 1;
+done:
+    return r;
+}
+
+
+int spsc_ring_push(spsc_ring_t *self, void *item) {
+    size_t tail;
+    int status = check_valid(self);
+    if(status != ALC_SPSC_RING_SUCCESS) {
+        goto done;
+    }
+    tail = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    if(tail - self->cached_head > self->mask) {
+        self->cached_head = atomic_load_explicit(
+            &self->head, memory_order_acquire
+        );
+        if(tail - self->cached_head > self->mask) {
+            status = ALC_SPSC_RING_FULL;
+            goto done;
+        }
+    }
+    dynabuf_set(self->buf, tail & self->mask, item);
+    atomic_store_explicit(&self->tail, tail + 1, memory_order_release);
+done:
+    return status;
+}
+
+
+int spsc_ring_pop(spsc_ring_t *self, void *dest) {
+    size_t head;
+    int status = check_valid(self);
+    if(status != ALC_SPSC_RING_SUCCESS || dest == NULL) {
+        status = ALC_SPSC_RING_INVALID;
+        goto done;
+    }
+    head = atomic_load_explicit(&self->head, memory_order_relaxed);
+    if(head == self->cached_tail) {
+        self->cached_tail = atomic_load_explicit(
+            &self->tail, memory_order_acquire
+        );
+        if(head == self->cached_tail) {
+            status = ALC_SPSC_RING_EMPTY;
+            goto done;
+        }
+    }
+    memcpy(dest, dynabuf_at(self->buf, head & self->mask),
+            self->buf->elem_size);
+    atomic_store_explicit(&self->head, head + 1, memory_order_release);
+done:
+    return status;
+}
+
+
+int64_t spsc_ring_push_n(spsc_ring_t *self, const void *src, size_t count) {
+    int64_t r;
+    size_t tail;
+    size_t room;
+    if(check_valid(self) != ALC_SPSC_RING_SUCCESS
+            || (src == NULL && count > 0)) {
+        r = ALC_SPSC_RING_INVALID;
+        goto done;
+    }
+    tail = atomic_load_explicit(&self->tail, memory_order_relaxed);
+    room = self->mask + 1 - (tail - self->cached_head);
+    if(room < count) {
+        self->cached_head = atomic_load_explicit(
+            &self->head, memory_order_acquire
+        );
+        room = self->mask + 1 - (tail - self->cached_head);
+    }
+    count = (count < room) ? count:room;
+    copy_in(self, tail, src, count);
+    atomic_store_explicit(&self->tail, tail + count, memory_order_release);
+    r = count;
+done:
+    return r;
+}
+
+
+int64_t spsc_ring_pop_n(spsc_ring_t *self, void *dest, size_t count) {
+    int64_t r;
+    size_t head;
+    size_t avail;
+    if(check_valid(self) != ALC_SPSC_RING_SUCCESS
+            || (dest == NULL && count > 0)) {
+        r = ALC_SPSC_RING_INVALID;
+        goto done;
+    }
+    head = atomic_load_explicit(&self->head, memory_order_relaxed);
+    avail = self->cached_tail - head;
+    if(avail < count) {
+        self->cached_tail = atomic_load_explicit(
+            &self->tail, memory_order_acquire
+        );
+        avail = self->cached_tail - head;
+    }
+    count = (count < avail) ? count:avail;
+    copy_out(self, head, dest, count);
+    atomic_store_explicit(&self->head, head + count, memory_order_release);
+    r = count;
+done:
+    return r;
+}
+
+
+int64_t spsc_ring_size(spsc_ring_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_SPSC_RING_SUCCESS) {
+        size_t head = atomic_load_explicit(&self->head, memory_order_acquire);
+        size_t tail = atomic_load_explicit(&self->tail, memory_order_acquire);
+        // head may have been read before a push and a pop which moved both
+        size = (tail - head > self->mask + 1) ? 0:tail - head;
+    }
+    return size;
+}
+
+
+int64_t spsc_ring_capacity(spsc_ring_t *self) {
+    int64_t capacity = -1;
+    if(check_valid(self) == ALC_SPSC_RING_SUCCESS) {
+        capacity = self->mask + 1;
+    }
+    return capacity;
+}
+
+
+void spsc_ring_free(spsc_ring_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    dynabuf_free(self->buf);
+    free(self);
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(spsc_ring_t *self) {
+    int status = ALC_SPSC_RING_SUCCESS;
+    if(self == NULL || self->buf == NULL) {
+        status = ALC_SPSC_RING_INVALID;
+    }
+    return status;
+}
+
+// copy count elements into the slots starting at counter value at, which may
+// wrap around the end of the buffer.
+static void copy_in(spsc_ring_t *self, size_t at, const char *src,
+        size_t count) {
+    size_t unit = self->buf->elem_size;
+    size_t slot = at & self->mask;
+    size_t first = self->mask + 1 - slot;
+    first = (count < first) ? count:first;
+    memcpy(dynabuf_at(self->buf, slot), src, first*unit);
+    memcpy(dynabuf_at(self->buf, 0), src + first*unit, (count - first)*unit);
+}
+
+static void copy_out(spsc_ring_t *self, size_t at, char *dest, size_t count) {
+    size_t unit = self->buf->elem_size;
+    size_t slot = at & self->mask;
+    size_t first = self->mask + 1 - slot;
+    first = (count < first) ? count:first;
+    memcpy(dest, dynabuf_at(self->buf, slot), first*unit);
+    memcpy(dest + first*unit, dynabuf_at(self->buf, 0), (count - first)*unit);
+}
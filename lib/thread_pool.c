@@ -0,0 +1,164 @@
+#include <alibc/containers/thread_pool.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// private functions
+static void *worker(void *arg);
+static void run_tasks(thread_pool_t *self);
+
+
+thread_pool_t *create_thread_pool(int nthreads) {
+    thread_pool_t *r = NULL;
+    int started = 0;
+    if(nthreads < 0) {
+        DBG_LOG("Invalid thread count %d\n", nthreads);
+        goto done;
+    }
+    if(nthreads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (cpus > 0) ? (int)cpus:1;
+    }
+
+    r = malloc(sizeof(thread_pool_t));
+    if(r == NULL) {
+        DBG_LOG("Could not malloc thread_pool_t\n");
+        goto done;
+    }
+    // the submitting thread is one of the nthreads
+    r->threads = malloc(sizeof(pthread_t) * (nthreads - 1 ? nthreads - 1:1));
+    if(r->threads == NULL) {
+        DBG_LOG("Could not malloc thread table\n");
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    pthread_mutex_init(&r->lock, NULL);
+    pthread_cond_init(&r->wake, NULL);
+    pthread_cond_init(&r->done, NULL);
+    r->fn           = NULL;
+    r->arg          = NULL;
+    r->ntasks       = 0;
+    r->next         = 0;
+    r->pending      = 0;
+    r->generation   = 0;
+    r->nthreads     = nthreads;
+    r->shutdown     = 0;
+    r->status       = ALC_THREAD_POOL_SUCCESS;
+
+    for(started = 0; started < nthreads - 1; started++) {
+        if(pthread_create(&r->threads[started], NULL, worker, r) != 0) {
+            DBG_LOG("Could not start worker thread %d\n", started);
+            break;
+        }
+    }
+    if(started < nthreads - 1) {
+        // join whatever was started, then give up
+        r->nthreads = started + 1;
+        thread_pool_free(r);
+        r = NULL;
+    }
+done:
+    return r;
+}
+
+
+int thread_pool_run(thread_pool_t *self, task_fn *fn, void *arg,
+        size_t ntasks) {
+    int status = ALC_THREAD_POOL_SUCCESS;
+    if(self == NULL || self->threads == NULL) {
+        status = ALC_THREAD_POOL_INVALID;
+        goto invalid_status;
+    }
+    if(fn == NULL) {
+        status = ALC_THREAD_POOL_INVALID;
+        goto done;
+    }
+    if(ntasks == 0) {
+        goto done;
+    }
+
+    pthread_mutex_lock(&self->lock);
+    self->fn        = fn;
+    self->arg       = arg;
+    self->ntasks    = ntasks;
+    self->next      = 0;
+    self->pending   = ntasks;
+    self->generation++;
+    pthread_cond_broadcast(&self->wake);
+    run_tasks(self);
+    while(self->pending > 0) {
+        pthread_cond_wait(&self->done, &self->lock);
+    }
+    pthread_mutex_unlock(&self->lock);
+done:
+    self->status = status;
+invalid_status:
+    return status;
+}
+
+
+int thread_pool_size(thread_pool_t *self) {
+    return (self == NULL) ? -1:self->nthreads;
+}
+
+
+void thread_pool_free(thread_pool_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    pthread_mutex_lock(&self->lock);
+    self->shutdown = 1;
+    pthread_cond_broadcast(&self->wake);
+    pthread_mutex_unlock(&self->lock);
+    for(int i = 0; i < self->nthreads - 1; i++) {
+        pthread_join(self->threads[i], NULL);
+    }
+    pthread_cond_destroy(&self->done);
+    pthread_cond_destroy(&self->wake);
+    pthread_mutex_destroy(&self->lock);
+    free(self->threads);
+    free(self);
+}
+
+
+int thread_pool_status(thread_pool_t *self) {
+    return (self == NULL) ? ALC_THREAD_POOL_INVALID:self->status;
+}
+
+/*
+ * Helper functions
+ */
+
+// claim and run tasks of the current batch until none are left.  Must be
+// called with the lock held; it is released while each task runs.
+static void run_tasks(thread_pool_t *self) {
+    while(self->next < self->ntasks) {
+        size_t task = self->next++;
+        pthread_mutex_unlock(&self->lock);
+        self->fn(self->arg, task);
+        pthread_mutex_lock(&self->lock);
+        if(--self->pending == 0) {
+            pthread_cond_signal(&self->done);
+        }
+    }
+}
+
+static void *worker(void *arg) {
+    thread_pool_t *self = arg;
+    size_t seen = 0;
+    pthread_mutex_lock(&self->lock);
+    for(;;) {
+        while(!self->shutdown && self->generation == seen) {
+            pthread_cond_wait(&self->wake, &self->lock);
+        }
+        if(self->shutdown) {
+            break;
+        }
+        seen = self->generation;
+        run_tasks(self);
+    }
+    pthread_mutex_unlock(&self->lock);
+    return NULL;
+}
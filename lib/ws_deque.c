@@ -0,0 +1,238 @@
+#include <alibc/containers/ws_deque.h>
+#include <alibc/containers/dynabuf.h>
+#include <alibc/containers/debug.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * The memory orderings follow Le, Pop, Cohen and Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+
+// private functions
+static int check_valid(ws_deque_t *self);
+static _Atomic(void*) *slot(dynabuf_t *buf, int64_t pos);
+static size_t buf_count(dynabuf_t *buf);
+static dynabuf_t *grow(ws_deque_t *self, dynabuf_t *old, int64_t top,
+        int64_t bottom);
+
+
+ws_deque_t *create_ws_deque(size_t size) {
+    ws_deque_t *r = NULL;
+    dynabuf_t *buf;
+    size_t capacity = 1;
+    if(size == 0 || size > (size_t)INT64_MAX / sizeof(void*)) {
+        DBG_LOG("Invalid deque size %zu\n", size);
+        goto done;
+    }
+    while(capacity < size) {
+        capacity <<= 1;
+    }
+
+    // the struct is cache line aligned, which malloc does not provide
+    if(posix_memalign((void**)&r, ALC_WS_DEQUE_CACHELINE,
+            sizeof(ws_deque_t)) != 0) {
+        r = NULL;
+        DBG_LOG("Could not allocate ws_deque_t\n");
+        goto done;
+    }
+    buf = create_dynabuf(capacity, sizeof(_Atomic(void*)));
+    r->retired = create_dynabuf(1, sizeof(dynabuf_t*));
+    if(buf == NULL || r->retired == NULL) {
+        DBG_LOG("Could not create dynabufs for deque\n");
+        dynabuf_free(buf);
+        dynabuf_free(r->retired);
+        free(r);
+        r = NULL;
+        goto done;
+    }
+    r->nretired = 0;
+    atomic_init(&r->top, 0);
+    atomic_init(&r->bottom, 0);
+    atomic_init(&r->buf, buf);
+done:
+    return r;
+}
+
+
+int ws_deque_push(ws_deque_t *self, void *item) {
+    int64_t bottom;
+    int64_t top;
+    dynabuf_t *buf;
+    int status = check_valid(self);
+    if(status != ALC_WS_DEQUE_SUCCESS) {
+        goto done;
+    }
+    bottom = atomic_load_explicit(&self->bottom, memory_order_relaxed);
+    top = atomic_load_explicit(&self->top, memory_order_acquire);
+    buf = atomic_load_explicit(&self->buf, memory_order_relaxed);
+    if(bottom - top > (int64_t)buf_count(buf) - 1) {
+        buf = grow(self, buf, top, bottom);
+        if(buf == NULL) {
+            DBG_LOG("Could not grow deque\n");
+            status = ALC_WS_DEQUE_NO_MEM;
+            goto done;
+        }
+    }
+    atomic_store_explicit(slot(buf, bottom), item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&self->bottom, bottom + 1, memory_order_relaxed);
+done:
+    return status;
+}
+
+
+int ws_deque_pop(ws_deque_t *self, void **out) {
+    int64_t bottom;
+    int64_t top;
+    dynabuf_t *buf;
+    void *item;
+    int status = check_valid(self);
+    if(status != ALC_WS_DEQUE_SUCCESS || out == NULL) {
+        status = ALC_WS_DEQUE_INVALID;
+        goto done;
+    }
+    bottom = atomic_load_explicit(&self->bottom, memory_order_relaxed) - 1;
+    buf = atomic_load_explicit(&self->buf, memory_order_relaxed);
+    // reserve the bottom element before looking at top
+    atomic_store_explicit(&self->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    top = atomic_load_explicit(&self->top, memory_order_relaxed);
+
+    if(top > bottom) {
+        status = ALC_WS_DEQUE_EMPTY;
+        atomic_store_explicit(&self->bottom, bottom + 1, memory_order_relaxed);
+        goto done;
+    }
+    item = atomic_load_explicit(slot(buf, bottom), memory_order_relaxed);
+    if(top == bottom) {
+        // last element, race any thieves for it through top
+        if(!atomic_compare_exchange_strong_explicit(&self->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed)) {
+            status = ALC_WS_DEQUE_EMPTY;
+        }
+        atomic_store_explicit(&self->bottom, bottom + 1, memory_order_relaxed);
+    }
+    if(status == ALC_WS_DEQUE_SUCCESS) {
+        *out = item;
+    }
+done:
+    return status;
+}
+
+
+int ws_deque_steal(ws_deque_t *self, void **out) {
+    int64_t bottom;
+    int64_t top;
+    dynabuf_t *buf;
+    void *item;
+    int status = check_valid(self);
+    if(status != ALC_WS_DEQUE_SUCCESS || out == NULL) {
+        status = ALC_WS_DEQUE_INVALID;
+        goto done;
+    }
+    top = atomic_load_explicit(&self->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    bottom = atomic_load_explicit(&self->bottom, memory_order_acquire);
+    if(top >= bottom) {
+        status = ALC_WS_DEQUE_EMPTY;
+        goto done;
+    }
+    // the paper uses consume here, which compilers implement as acquire
+    buf = atomic_load_explicit(&self->buf, memory_order_acquire);
+    item = atomic_load_explicit(slot(buf, top), memory_order_relaxed);
+    if(!atomic_compare_exchange_strong_explicit(&self->top, &top, top + 1,
+            memory_order_seq_cst, memory_order_relaxed)) {
+        status = ALC_WS_DEQUE_ABORT;
+        goto done;
+    }
+    *out = item;
+done:
+    return status;
+}
+
+
+int64_t ws_deque_size(ws_deque_t *self) {
+    int64_t size = -1;
+    if(check_valid(self) == ALC_WS_DEQUE_SUCCESS) {
+        int64_t bottom = atomic_load_explicit(
+            &self->bottom, memory_order_acquire
+        );
+        int64_t top = atomic_load_explicit(&self->top, memory_order_acquire);
+        size = (bottom > top) ? bottom - top:0;
+    }
+    return size;
+}
+
+
+void ws_deque_free(ws_deque_t *self) {
+    if(self == NULL) {
+        DBG_LOG("self was null\n");
+        return;
+    }
+    if(self->retired != NULL) {
+        for(size_t i = 0; i < self->nretired; i++) {
+            dynabuf_free(*(dynabuf_t**)dynabuf_fetch(self->retired, i));
+        }
+        dynabuf_free(self->retired);
+    }
+    dynabuf_free(atomic_load_explicit(&self->buf, memory_order_relaxed));
+    free(self);
+}
+
+/*
+ * Helper functions
+ */
+
+static int check_valid(ws_deque_t *self) {
+    int status = ALC_WS_DEQUE_SUCCESS;
+    if(self == NULL || self->retired == NULL) {
+        status = ALC_WS_DEQUE_INVALID;
+    }
+    return status;
+}
+
+static _Atomic(void*) *slot(dynabuf_t *buf, int64_t pos) {
+    return (_Atomic(void*)*)dynabuf_at(buf, pos & (buf_count(buf) - 1));
+}
+
+static size_t buf_count(dynabuf_t *buf) {
+    return buf->capacity / buf->elem_size;
+}
+
+/*
+ * Replace the owner's buffer with one twice the size holding the same
+ * elements at the same positions.  The old buffer is retired rather than
+ * freed, since thieves may still be reading from it.  Owner thread only.
+ * @return the new buffer, or NULL on errors.
+ */
+static dynabuf_t *grow(ws_deque_t *self, dynabuf_t *old, int64_t top,
+        int64_t bottom) {
+    dynabuf_t *buf = NULL;
+    size_t count = buf_count(old);
+    if(count > (size_t)INT64_MAX / 2 / sizeof(void*)) {
+        goto done;
+    }
+    if((self->nretired + 1) * sizeof(dynabuf_t*) > self->retired->capacity) {
+        if(dynabuf_resize(self->retired,
+                dynabuf_grow_count(self->retired, self->nretired + 1))
+                != ALC_DYNABUF_SUCCESS) {
+            goto done;
+        }
+    }
+    buf = create_dynabuf(count * 2, sizeof(_Atomic(void*)));
+    if(buf == NULL) {
+        goto done;
+    }
+    for(int64_t i = top; i < bottom; i++) {
+        atomic_store_explicit(slot(buf, i),
+            atomic_load_explicit(slot(old, i), memory_order_relaxed),
+            memory_order_relaxed
+        );
+    }
+    dynabuf_set(self->retired, self->nretired++, old);
+    atomic_store_explicit(&self->buf, buf, memory_order_release);
+done:
+    return buf;
+}
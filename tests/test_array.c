@@ -3,7 +3,11 @@
 #include <alibc/containers/array.h>
 #include <alibc/containers/iterator.h>
 #include <alibc/containers/array_iterator.h>
+#include <alibc/containers/array_sort.h>
+#include <alibc/containers/array_parallel.h>
+#include <alibc/containers/array_simd.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
@@ -93,6 +97,476 @@ static void test_append(void **state) {
     assert_true(strcmp(result, "jumped over") == 0);
 }
 
+static void test_append_n(void **state) {
+    array_t *at_uut = *state;
+    assert_int_equal(array_append_n(at_uut, data, 4), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 8);
+    for(int i = 0; i < 8; i++) {
+        assert_true(strcmp(*array_fetch(at_uut, i), data[i % 4]) == 0);
+    }
+
+    // bulk append of integers, several growth steps at once
+    array_t *uut = create_array(1, sizeof(int));
+    int values[1000];
+    for(int i = 0; i < 1000; i++) {
+        values[i] = i;
+    }
+    assert_int_equal(array_append_n(uut, values, 1000), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_append_n(uut, values, 0), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(uut), 1000);
+    assert_true(memcmp(array_data(uut), values, sizeof(values)) == 0);
+
+    // bad arguments are rejected before any growth happens
+    size_t capacity = uut->data->capacity;
+    assert_int_equal(array_append_n(uut, NULL, 5000), ALC_ARRAY_INVALID);
+    assert_int_equal(uut->data->capacity, capacity);
+    assert_int_equal(array_append_n(uut, values, SIZE_MAX), ALC_ARRAY_NO_MEM);
+    assert_int_equal(uut->data->capacity, capacity);
+    assert_int_equal(array_size(uut), 1000);
+    assert_int_equal(array_append_n(NULL, values, 1), ALC_ARRAY_INVALID);
+    array_free(uut);
+}
+
+static void test_extend(void **state) {
+    array_t *at_uut = *state;
+    array_t *other = create_array(1, sizeof(char*));
+    array_append(other, "lorem ipsum");
+    assert_int_equal(array_extend(at_uut, other), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 5);
+    assert_true(strcmp(*array_fetch(at_uut, 4), "lorem ipsum") == 0);
+
+    // extending with itself doubles the contents
+    assert_int_equal(array_extend(at_uut, at_uut), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 10);
+    assert_true(strcmp(*array_fetch(at_uut, 7), "jumped over") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 9), "lorem ipsum") == 0);
+
+    // unit sizes must match
+    array_t *mismatch = create_array(1, sizeof(int));
+    assert_int_equal(array_extend(at_uut, mismatch), ALC_ARRAY_INVALID);
+    assert_int_equal(array_extend(at_uut, NULL), ALC_ARRAY_INVALID);
+    array_free(mismatch);
+    array_free(other);
+}
+
+static void test_insert_range(void **state) {
+    array_t *at_uut = *state;
+    char *block[] = {"lorem", "ipsum"};
+    // displaced block lies entirely within the array
+    assert_int_equal(array_insert_range(at_uut, 1, block, 2),
+            ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 6);
+    assert_true(strcmp(*array_fetch(at_uut, 0), "the quick") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 1), "lorem") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 2), "ipsum") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 3), "the lazy dog") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 4), "brown fox") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 5), "jumped over") == 0);
+
+    // displaced block runs past the end of the array
+    char *tail[] = {"a", "b", "c"};
+    assert_int_equal(array_insert_range(at_uut, 5, tail, 3),
+            ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 9);
+    assert_true(strcmp(*array_fetch(at_uut, 5), "a") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 7), "c") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 8), "jumped over") == 0);
+
+    // insertion at the end decays to append
+    assert_int_equal(array_insert_range(at_uut, 9, block, 2),
+            ALC_ARRAY_SUCCESS);
+    assert_true(strcmp(*array_fetch(at_uut, 10), "ipsum") == 0);
+
+    assert_int_equal(array_insert_range(at_uut, 20, block, 2),
+            ALC_ARRAY_IDX_OOB);
+    assert_int_equal(array_insert_range(NULL, 0, block, 2),
+            ALC_ARRAY_INVALID);
+
+    size_t capacity = at_uut->data->capacity;
+    assert_int_equal(array_insert_range(at_uut, 0, NULL, 5000),
+            ALC_ARRAY_INVALID);
+    assert_int_equal(array_insert_range(at_uut, 0, block, SIZE_MAX),
+            ALC_ARRAY_NO_MEM);
+    assert_int_equal(at_uut->data->capacity, capacity);
+    assert_int_equal(array_size(at_uut), 11);
+}
+
+static void test_insert_ordered(void **state) {
+    array_t *at_uut = *state;
+    assert_int_equal(array_insert_ordered(at_uut, 1, "lorem ipsum"),
+            ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_insert_ordered(at_uut, 5, "tail"),
+            ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_insert_ordered(at_uut, 0, "head"),
+            ALC_ARRAY_SUCCESS);
+    char *expect[] = {"head", "the quick", "lorem ipsum", "brown fox",
+                      "jumped over", "the lazy dog", "tail"};
+    assert_int_equal(array_size(at_uut), 7);
+    for(int i = 0; i < 7; i++) {
+        assert_true(strcmp(*array_fetch(at_uut, i), expect[i]) == 0);
+    }
+    assert_int_equal(array_insert_ordered(at_uut, 8, "oob"),
+            ALC_ARRAY_IDX_OOB);
+    assert_int_equal(array_insert_ordered(NULL, 0, "invalid"),
+            ALC_ARRAY_INVALID);
+}
+
+static void test_erase_range(void **state) {
+    array_t *at_uut = *state;
+    assert_int_equal(array_erase_range(at_uut, 1, 2), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 2);
+    assert_true(strcmp(*array_fetch(at_uut, 0), "the quick") == 0);
+    assert_true(strcmp(*array_fetch(at_uut, 1), "the lazy dog") == 0);
+
+    assert_int_equal(array_erase_range(at_uut, 1, 2), ALC_ARRAY_IDX_OOB);
+    assert_int_equal(array_erase_range(at_uut, 3, 0), ALC_ARRAY_IDX_OOB);
+    assert_int_equal(array_erase_range(at_uut, 2, 0), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_erase_range(at_uut, 0, 2), ALC_ARRAY_SUCCESS);
+    assert_int_equal(array_size(at_uut), 0);
+    assert_int_equal(array_erase_range(NULL, 0, 0), ALC_ARRAY_INVALID);
+}
+
+static bool is_odd(void **item, void *arg) {
+    return (*(int*)item % 2) == 1;
+}
+
+static bool is_above(void **item, void *arg) {
+    return *(int*)item > *(int*)arg;
+}
+
+// removes every other item it is called on, so a second call on the same
+// item would give a different answer.
+static bool alternate(void **item, void *arg) {
+    size_t *calls = arg;
+    return (*calls)++ % 2 == 1;
+}
+
+static void test_remove_if(void **state) {
+    array_t *uut = create_array(1, sizeof(int));
+    for(int i = 0; i < 100; i++) {
+        array_append(uut, (void*)(intptr_t)i);
+    }
+    assert_int_equal(array_remove_if(uut, is_odd, NULL), 50);
+    assert_int_equal(array_size(uut), 50);
+    for(int i = 0; i < 50; i++) {
+        assert_int_equal(*(int*)array_fetch(uut, i), 2*i);
+    }
+
+    int threshold = 89;
+    assert_int_equal(array_remove_if(uut, is_above, &threshold), 5);
+    assert_int_equal(array_size(uut), 45);
+    assert_int_equal(*(int*)array_fetch(uut, 44), 88);
+
+    // nothing matches
+    assert_int_equal(array_remove_if(uut, is_above, &threshold), 0);
+    assert_int_equal(array_remove_if(uut, NULL, NULL), ALC_ARRAY_INVALID);
+    assert_int_equal(array_remove_if(NULL, is_odd, NULL), ALC_ARRAY_INVALID);
+
+    // one predicate call per item
+    size_t calls = 0;
+    assert_int_equal(array_remove_if(uut, alternate, &calls), 22);
+    assert_int_equal(calls, 45);
+    assert_int_equal(array_size(uut), 23);
+    for(int i = 0; i < 23; i++) {
+        assert_int_equal(*(int*)array_fetch(uut, i), 4*i);
+    }
+    array_free(uut);
+}
+
+static int8_t cmp_int(void *a, void *b) {
+    int x = (int)(intptr_t)a;
+    int y = (int)(intptr_t)b;
+    return (x > y) - (x < y);
+}
+
+// orders struct test by its first string
+static int8_t cmp_test(void *a, void *b) {
+    int r = strcmp(((struct test*)a)->a, ((struct test*)b)->a);
+    return (r > 0) - (r < 0);
+}
+
+static void test_sort(void **state) {
+    array_t *uut = create_array(1, sizeof(int));
+    unsigned seed = 12345;
+    for(int i = 0; i < 5000; i++) {
+        seed = seed*1103515245 + 12345;
+        array_append(uut, (void*)(intptr_t)((int)(seed >> 8) % 1000 - 500));
+    }
+    assert_int_equal(array_sort(uut, cmp_int), ALC_ARRAY_SUCCESS);
+    for(int i = 1; i < 5000; i++) {
+        assert_true(*(int*)array_fetch(uut, i - 1)
+                <= *(int*)array_fetch(uut, i));
+    }
+    // already sorted and reversed input
+    assert_int_equal(array_sort(uut, cmp_int), ALC_ARRAY_SUCCESS);
+    for(int i = 0; i < 2500; i++) {
+        array_swap(uut, i, 4999 - i);
+    }
+    assert_int_equal(array_sort(uut, cmp_int), ALC_ARRAY_SUCCESS);
+    for(int i = 1; i < 5000; i++) {
+        assert_true(*(int*)array_fetch(uut, i - 1)
+                <= *(int*)array_fetch(uut, i));
+    }
+    assert_int_equal(array_sort(uut, NULL), ALC_ARRAY_INVALID);
+    assert_int_equal(array_sort(NULL, cmp_int), ALC_ARRAY_INVALID);
+    array_free(uut);
+}
+
+static void test_sort_big(void **state) {
+    array_t *uut = *state;
+    char names[40][4];
+    for(int i = 0; i < 40; i++) {
+        struct test item = {names[i], NULL};
+        snprintf(names[i], sizeof(names[i]), "%02d", (i*7) % 40);
+        array_append(uut, &item);
+    }
+    assert_int_equal(array_sort(uut, cmp_test), ALC_ARRAY_SUCCESS);
+    for(int i = 0; i < 40; i++) {
+        char expect[4];
+        snprintf(expect, sizeof(expect), "%02d", i);
+        assert_string_equal(((struct test*)array_fetch(uut, i))->a, expect);
+    }
+}
+
+static void test_radix_sort(void **state) {
+    array_t *uut = create_array(1, sizeof(int));
+    unsigned seed = 42;
+    for(int i = 0; i < 5000; i++) {
+        seed = seed*1103515245 + 12345;
+        array_append(uut, (void*)(intptr_t)(int)seed);
+    }
+    assert_int_equal(array_radix_sort(uut, true), ALC_ARRAY_SUCCESS);
+    for(int i = 1; i < 5000; i++) {
+        assert_true(*(int*)array_fetch(uut, i - 1)
+                <= *(int*)array_fetch(uut, i));
+    }
+    // unsigned order puts the negative numbers last
+    assert_int_equal(array_radix_sort(uut, false), ALC_ARRAY_SUCCESS);
+    for(int i = 1; i < 5000; i++) {
+        assert_true(*(unsigned*)array_fetch(uut, i - 1)
+                <= *(unsigned*)array_fetch(uut, i));
+    }
+    array_free(uut);
+
+    uut = create_array(1, sizeof(int64_t));
+    for(int64_t i = 0; i < 300; i++) {
+        array_append(uut, (void*)((i % 2) ? -i*1000000007LL:i << 40));
+    }
+    assert_int_equal(array_radix_sort(uut, true), ALC_ARRAY_SUCCESS);
+    for(int i = 1; i < 300; i++) {
+        assert_true(*(int64_t*)array_fetch(uut, i - 1)
+                <= *(int64_t*)array_fetch(uut, i));
+    }
+    array_free(uut);
+
+    uut = create_array(1, sizeof(char));
+    for(int i = 0; i < 256; i++) {
+        array_append(uut, (void*)(intptr_t)(255 - i));
+    }
+    assert_int_equal(array_radix_sort(uut, false), ALC_ARRAY_SUCCESS);
+    for(int i = 0; i < 256; i++) {
+        assert_int_equal(*(unsigned char*)array_fetch(uut, i), i);
+    }
+    array_free(uut);
+
+    uut = create_array(1, sizeof(struct test));
+    assert_int_equal(array_radix_sort(uut, false), ALC_ARRAY_INVALID);
+    assert_int_equal(array_radix_sort(NULL, false), ALC_ARRAY_INVALID);
+    array_free(uut);
+}
+
+static void test_bounds(void **state) {
+    int values[] = {1, 3, 3, 3, 7, 10};
+    array_t *uut = create_array(1, sizeof(int));
+    for(int i = 0; i < 6; i++) {
+        array_append(uut, (void*)(intptr_t)values[i]);
+    }
+    assert_int_equal(array_lower_bound(uut, (void*)3, cmp_int), 1);
+    assert_int_equal(array_upper_bound(uut, (void*)3, cmp_int), 4);
+    assert_int_equal(array_lower_bound(uut, (void*)0, cmp_int), 0);
+    assert_int_equal(array_lower_bound(uut, (void*)11, cmp_int), 6);
+    assert_int_equal(array_upper_bound(uut, (void*)10, cmp_int), 6);
+    assert_int_equal(array_lower_bound(uut, (void*)8, cmp_int), 5);
+
+    assert_int_equal(*(int*)array_bsearch(uut, (void*)7, cmp_int), 7);
+    assert_ptr_equal(array_bsearch(uut, (void*)3, cmp_int),
+            array_fetch(uut, 1));
+    assert_null(array_bsearch(uut, (void*)4, cmp_int));
+    assert_null(array_bsearch(uut, (void*)11, cmp_int));
+
+    assert_int_equal(array_lower_bound(uut, (void*)3, NULL), ALC_ARRAY_INVALID);
+    assert_int_equal(array_upper_bound(NULL, (void*)3, cmp_int),
+            ALC_ARRAY_INVALID);
+    assert_null(array_bsearch(NULL, (void*)3, cmp_int));
+    array_free(uut);
+
+    // large elements are passed by pointer, as is the key
+    uut = *state;
+    char names[10][4];
+    for(int i = 0; i < 10; i++) {
+        struct test item = {names[i], NULL};
+        snprintf(names[i], sizeof(names[i]), "%02d", i*2);
+        array_append(uut, &item);
+    }
+    struct test key = {"08", NULL};
+    assert_int_equal(array_lower_bound(uut, &key, cmp_test), 4);
+    assert_ptr_equal(array_bsearch(uut, &key, cmp_test), array_fetch(uut, 4));
+    key.a = "09";
+    assert_int_equal(array_lower_bound(uut, &key, cmp_test), 5);
+    assert_null(array_bsearch(uut, &key, cmp_test));
+}
+
+static void test_simd(void **state) {
+    array_t *uut = create_array(1, sizeof(int32_t));
+    int64_t out;
+    for(int i = 0; i < 1000; i++) {
+        array_append(uut, (void*)(intptr_t)((i % 10) - 5));
+    }
+    array_append(uut, (void*)(intptr_t)123);
+    assert_int_equal(array_find_i32(uut, 123), 1000);
+    assert_int_equal(array_find_i32(uut, -3), 2);
+    assert_int_equal(array_find_i32(uut, 77), 1001);
+    assert_int_equal(array_count_eq(uut, -5), 100);
+    assert_int_equal(array_min(uut, true, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, -5);
+    assert_int_equal(array_max(uut, true, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, 123);
+    // -1 is the largest unsigned value
+    assert_int_equal(array_max(uut, false, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, (uint32_t)-1);
+    assert_int_equal(array_sum(uut, true, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, -500 + 123);
+    assert_int_equal(array_find_i64(uut, 1), ALC_ARRAY_INVALID);
+    assert_int_equal(array_status(uut), ALC_ARRAY_INVALID);
+    array_free(uut);
+
+    uut = create_array(1, sizeof(int64_t));
+    assert_int_equal(array_min(uut, true, &out), ALC_ARRAY_IDX_OOB);
+    assert_int_equal(array_status(uut), ALC_ARRAY_IDX_OOB);
+    assert_int_equal(array_find_i64(uut, 1), 0);
+    assert_int_equal(array_status(uut), ALC_ARRAY_SUCCESS);
+    for(int64_t i = 0; i < 300; i++) {
+        array_append(uut, (void*)(i*i - 1000));
+    }
+    assert_int_equal(array_find_i64(uut, 299*299 - 1000), 299);
+    assert_int_equal(array_min(uut, true, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, -1000);
+    assert_int_equal(array_count_eq(uut, 24), 1);
+    array_free(uut);
+
+    uut = create_array(1, sizeof(uint8_t));
+    for(int i = 0; i < 200; i++) {
+        array_append(uut, (void*)(intptr_t)(i + 20));
+    }
+    assert_int_equal(array_max(uut, false, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, 219);
+    assert_int_equal(array_min(uut, true, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, -128);
+    assert_int_equal(array_sum(uut, false, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, 200*20 + 199*200/2);
+    assert_int_equal(array_count_eq(uut, 20 + 256), 1);
+    array_free(uut);
+
+    uut = create_array(1, sizeof(int16_t));
+    for(int i = 0; i < 70; i++) {
+        array_append(uut, (void*)(intptr_t)(-i));
+    }
+    assert_int_equal(array_sum(uut, true, &out), ALC_ARRAY_SUCCESS);
+    assert_int_equal(out, -69*70/2);
+    array_free(uut);
+
+    // elements which are not integers
+    uut = *state;
+    assert_int_equal(array_count_eq(uut, 0), ALC_ARRAY_INVALID);
+    assert_int_equal(array_sum(uut, true, &out), ALC_ARRAY_INVALID);
+    assert_int_equal(array_sum(NULL, true, &out), ALC_ARRAY_INVALID);
+    assert_int_equal(array_find_i32(NULL, 0), ALC_ARRAY_INVALID);
+}
+
+static void square_range(array_t *self, size_t begin, size_t end, void *arg) {
+    for(size_t i = begin; i < end; i++) {
+        int *item = (int*)array_at_unchecked(self, i);
+        *item = *item * *item;
+    }
+}
+
+static void sum_range(array_t *self, size_t begin, size_t end, void *partial,
+        void *arg) {
+    for(size_t i = begin; i < end; i++) {
+        *(int64_t*)partial += *(int*)array_at_unchecked(self, i);
+    }
+}
+
+static void sum_combine(void *result, void *partial, void *arg) {
+    *(int64_t*)result += *(int64_t*)partial;
+}
+
+static void test_parallel(void **state) {
+    thread_pool_t *pool = create_thread_pool(4);
+    array_t *uut = create_array(1, sizeof(int));
+    int64_t sum = 0;
+    assert_non_null(pool);
+    for(int i = 0; i < 100000; i++) {
+        array_append(uut, (void*)(intptr_t)(i % 100));
+    }
+    assert_int_equal(array_parallel_for(uut, pool, square_range, NULL),
+            ALC_ARRAY_SUCCESS);
+    assert_int_equal(*(int*)array_fetch(uut, 99999), 99*99);
+    assert_int_equal(array_parallel_reduce(uut, pool, sum_range, sum_combine,
+                &sum, sizeof(sum), NULL), ALC_ARRAY_SUCCESS);
+    // 1000 runs of 0^2..99^2
+    assert_int_equal(sum, 1000*328350LL);
+
+    assert_int_equal(array_parallel_for(uut, NULL, square_range, NULL),
+            ALC_ARRAY_INVALID);
+    assert_int_equal(array_parallel_for(NULL, pool, square_range, NULL),
+            ALC_ARRAY_INVALID);
+    assert_int_equal(array_parallel_reduce(uut, pool, sum_range, NULL,
+                &sum, sizeof(sum), NULL), ALC_ARRAY_INVALID);
+    array_free(uut);
+    thread_pool_free(pool);
+}
+
+static void test_parallel_sort(void **state) {
+    thread_pool_t *pool = create_thread_pool(3);
+    array_t *uut = create_array(1, sizeof(int));
+    unsigned seed = 7;
+    assert_non_null(pool);
+    for(int i = 0; i < 200001; i++) {
+        seed = seed*1103515245 + 12345;
+        array_append(uut, (void*)(intptr_t)(int)(seed >> 4));
+    }
+    assert_int_equal(array_parallel_sort(uut, pool, cmp_int),
+            ALC_ARRAY_SUCCESS);
+    for(int i = 1; i < 200001; i++) {
+        assert_true(*(int*)array_fetch(uut, i - 1)
+                <= *(int*)array_fetch(uut, i));
+    }
+    array_free(uut);
+
+    // large elements, with more runs than merge slices per pair
+    uut = create_array(1, sizeof(struct test));
+    char (*names)[8] = malloc(50000*8);
+    for(int i = 0; i < 50000; i++) {
+        struct test item = {names[i], NULL};
+        snprintf(names[i], 8, "%05d", (i*7919) % 50000);
+        array_append(uut, &item);
+    }
+    assert_int_equal(array_parallel_sort(uut, pool, cmp_test),
+            ALC_ARRAY_SUCCESS);
+    for(int i = 0; i < 50000; i++) {
+        char expect[8];
+        snprintf(expect, sizeof(expect), "%05d", i);
+        assert_string_equal(((struct test*)array_fetch(uut, i))->a, expect);
+    }
+    free(names);
+    array_free(uut);
+
+    assert_int_equal(array_parallel_sort(NULL, pool, cmp_int),
+            ALC_ARRAY_INVALID);
+    thread_pool_free(pool);
+}
+
 static void test_fetch(void **state) {
     array_t *at_uut = *state;
     char *result    = *array_fetch(at_uut, 2);
@@ -108,6 +582,15 @@ static void test_fetch(void **state) {
     assert_null(result);
 }
 
+static void test_unchecked_access(void **state) {
+    array_t *at_uut = *state;
+    char **raw = array_data(at_uut);
+    for(int i = 0; i < array_size(at_uut); i++) {
+        assert_ptr_equal(array_at_unchecked(at_uut, i), array_fetch(at_uut, i));
+        assert_true(strcmp(raw[i], data[i]) == 0);
+    }
+}
+
 static void test_remove(void **state) {
     array_t *at_uut = *state;
     char *result    = *array_remove(at_uut, 2);
@@ -142,6 +625,72 @@ static void test_resize(void **state) {
     assert_int_equal(result, ALC_ARRAY_SUCCESS);
 }
 
+static void test_growth(void **state) {
+    array_t *uut = create_array(2, sizeof(int));
+    assert_int_equal(array_set_growth(uut, ALC_DYNABUF_GROW_HALF),
+            ALC_ARRAY_SUCCESS);
+    for(int i = 0; i < 3; i++) {
+        array_append(uut, (void*)(intptr_t)i);
+    }
+    // 1.5x + 1 of two elements
+    assert_int_equal(uut->data->capacity, 4*sizeof(int));
+    for(int i = 0; i < 3; i++) {
+        assert_int_equal(*(int*)array_fetch(uut, i), i);
+    }
+    assert_int_equal(array_set_growth(uut, 42), ALC_ARRAY_INVALID);
+    assert_int_equal(array_set_growth(NULL, 0), ALC_ARRAY_INVALID);
+    array_free(uut);
+}
+
+static void test_reserved(void **state) {
+    array_t *uut = create_array_reserved(1, sizeof(int), 4096);
+    assert_non_null(uut);
+    array_append(uut, (void*)42);
+    int *first = (int*)array_fetch(uut, 0);
+    for(int i = 1; i < 4096; i++) {
+        assert_int_equal(array_append(uut, (void*)(intptr_t)i),
+                ALC_ARRAY_SUCCESS);
+    }
+    // the first element never moved
+    assert_ptr_equal(first, array_fetch(uut, 0));
+    assert_int_equal(*first, 42);
+    assert_int_equal(*(int*)array_fetch(uut, 4095), 4095);
+
+    assert_int_equal(array_append(uut, (void*)1), ALC_ARRAY_NO_MEM);
+    array_free(uut);
+}
+
+static void test_mmap(void **state) {
+    char path[] = "/tmp/alc_test_array_XXXXXX";
+    int fd = mkstemp(path);
+    assert_true(fd >= 0);
+    close(fd);
+
+    array_t *uut = create_array_mmap(path, 1, sizeof(int));
+    assert_non_null(uut);
+    assert_int_equal(array_size(uut), 0);
+    for(int i = 0; i < 100; i++) {
+        array_append(uut, (void*)(intptr_t)i);
+    }
+    assert_int_equal(array_flush(uut), ALC_ARRAY_SUCCESS);
+    array_append(uut, (void*)100);
+    array_free(uut);
+
+    // the array is restored without being reloaded
+    uut = create_array_mmap(path, 1, sizeof(int));
+    assert_non_null(uut);
+    assert_int_equal(array_size(uut), 101);
+    for(int i = 0; i < 101; i++) {
+        assert_int_equal(*(int*)array_fetch(uut, i), i);
+    }
+    array_free(uut);
+
+    // the stored unit size must match
+    assert_null(create_array_mmap(path, 1, sizeof(char)));
+    unlink(path);
+    assert_int_equal(array_flush(NULL), ALC_ARRAY_INVALID);
+}
+
 static void test_indices(void **state) {
     array_t *uut    = create_array(1, sizeof(int));
     int result      = array_remove(uut, 0);
@@ -204,6 +753,129 @@ static void test_iterator(void **state) {
     iter_free(iter);
 }
 
+static void test_iterator_static(void **state) {
+    array_t *at_uut = *state;
+    iter_context iter;
+    int count = 0;
+    assert_int_equal(iter_init_array(NULL, at_uut), ALC_ITER_NULL);
+    assert_int_equal(iter_init_array(&iter, NULL), ALC_ITER_INVALID);
+    assert_null(iter_next(&iter));
+    assert_int_equal(iter_status(&iter), ALC_ITER_INVALID);
+
+    // a context on the stack walks the same elements as an allocated one
+    assert_int_equal(iter_init_array(&iter, at_uut), ALC_ITER_READY);
+    while(iter_status(&iter) != ALC_ITER_STOP) {
+        assert_ptr_equal(iter_next(&iter), array_fetch(at_uut, count));
+        count++;
+    }
+    assert_int_equal(count, array_size(at_uut));
+    // freeing a caller-provided context is a no-op
+    iter_free(&iter);
+}
+
+static void test_iterator_batch(void **state) {
+    array_t *at_uut = *state;
+    iter_context iter;
+    void **batch[3];
+    int count = 0;
+    int n;
+    for(int i = 0; i < 3; i++) {
+        array_append(at_uut, data[i]);
+    }
+    iter_init_array(&iter, at_uut);
+    // mixing single steps and batches keeps the order
+    assert_ptr_equal(iter_next(&iter), array_fetch(at_uut, count++));
+    while((n = iter_next_batch(&iter, (void**)batch, 3)) > 0) {
+        for(int i = 0; i < n; i++) {
+            assert_ptr_equal(batch[i], array_fetch(at_uut, count++));
+        }
+    }
+    assert_int_equal(n, 0);
+    assert_int_equal(count, 7);
+    assert_int_equal(iter_status(&iter), ALC_ITER_STOP);
+
+    // iterators without a batch function are driven through next
+    iter_init_array(&iter, at_uut);
+    iter.next_batch = NULL;
+    assert_int_equal(iter_next_batch(&iter, (void**)batch, 3), 3);
+    assert_ptr_equal(batch[2], array_fetch(at_uut, 2));
+    assert_int_equal(iter_next_batch(&iter, (void**)batch, 3), 3);
+    assert_int_equal(iter_next_batch(&iter, (void**)batch, 3), 1);
+    assert_ptr_equal(batch[0], array_fetch(at_uut, 6));
+    assert_int_equal(iter_next_batch(&iter, (void**)batch, 3), 0);
+
+    assert_int_equal(iter_next_batch(NULL, (void**)batch, 3), -1);
+    iter_init_array(&iter, at_uut);
+    assert_int_equal(iter_next_batch(&iter, NULL, 3), -1);
+    assert_int_equal(iter_next_batch(&iter, (void**)batch, -1), -1);
+}
+
+static void test_foreach(void **state) {
+    array_t *at_uut = *state;
+    void **item;
+    int count = 0;
+    ALC_ARRAY_FOREACH(at_uut, item) {
+        assert_ptr_equal(item, array_fetch(at_uut, count));
+        count++;
+    }
+    assert_int_equal(count, 4);
+
+    // break leaves item on the current element
+    ALC_ARRAY_FOREACH(at_uut, item) {
+        if(*item == data[2]) {
+            break;
+        }
+    }
+    assert_ptr_equal(item, array_fetch(at_uut, 2));
+}
+
+static void test_iterator_range(void **state) {
+    array_t *at_uut = *state;
+    iter_context parts[8];
+    void **next;
+    int count = 0;
+    for(int i = 0; i < 3; i++) {
+        array_append(at_uut, data[i]);
+    }
+    iter_context *iter = create_array_iterator_range(at_uut, 2, 5);
+    assert_non_null(iter);
+    for(next = iter_next(iter); next != NULL; next = iter_next(iter)) {
+        assert_ptr_equal(next, array_fetch(at_uut, 2 + count));
+        count++;
+    }
+    assert_int_equal(count, 3);
+    assert_int_equal(iter_status(iter), ALC_ITER_STOP);
+    iter_free(iter);
+
+    // the end of a range is clamped to the array size
+    iter = create_array_iterator_range(at_uut, 5, ALC_ITER_END);
+    assert_int_equal(iter_next_batch(iter, (void**)parts, 8), 2);
+    iter_free(iter);
+    assert_null(create_array_iterator_range(at_uut, 3, 2));
+    assert_null(create_array_iterator_range(NULL, 0, 2));
+
+    // the parts cover the remaining elements once, in order
+    iter = create_array_iterator(at_uut);
+    iter_next(iter);
+    assert_int_equal(iter_split(iter, parts, 4), 4);
+    count = 1;
+    for(int i = 0; i < 4; i++) {
+        assert_int_equal(parts[i].end - parts[i].index, (i < 2) ? 2:1);
+        while((next = iter_next(&parts[i])) != NULL) {
+            assert_ptr_equal(next, array_fetch(at_uut, count));
+            count++;
+        }
+        iter_free(&parts[i]);
+    }
+    assert_int_equal(count, 7);
+    // no empty parts are produced
+    assert_int_equal(iter_split(iter, parts, 8), 6);
+    assert_int_equal(iter_split(iter, parts, 0), -1);
+    assert_int_equal(iter_split(iter, NULL, 2), -1);
+    assert_int_equal(iter_split(NULL, parts, 2), -1);
+    iter_free(iter);
+}
+
 static void test_invalid_calls(void **state) {
     // test  all check_valid/check_space_available cases
     int r = array_insert(NULL, 0, NULL);
@@ -269,6 +941,30 @@ static void test_swap_big(void **state) {
     assert_true(strcmp(r2->b, t1.b) == 0);
 }
 
+static void test_swap_sizes(void **state) {
+    // the specialized sizes, an odd size, and one spanning several chunks
+    size_t sizes[] = {1, 2, 4, 8, 16, 32, 64, 24, 200};
+    unsigned char a[200];
+    unsigned char b[200];
+    for(int s = 0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+        size_t unit = sizes[s];
+        array_t *uut = create_array(2, unit);
+        for(size_t i = 0; i < unit; i++) {
+            a[i] = i;
+            b[i] = 255 - i;
+        }
+        array_append_n(uut, a, 1);
+        array_append_n(uut, b, 1);
+        assert_int_equal(array_swap(uut, 0, 1), ALC_ARRAY_SUCCESS);
+        assert_memory_equal(array_at_unchecked(uut, 0), b, unit);
+        assert_memory_equal(array_at_unchecked(uut, 1), a, unit);
+        // swapping an element with itself leaves it alone
+        assert_int_equal(array_swap(uut, 1, 1), ALC_ARRAY_SUCCESS);
+        assert_memory_equal(array_at_unchecked(uut, 1), a, unit);
+        array_free(uut);
+    }
+}
+
 
 int main(void) {
     const struct CMUnitTest tests[] = {
@@ -277,11 +973,59 @@ int main(void) {
             at_init,
             at_finish
         ),
+        cmocka_unit_test_setup_teardown(
+            test_append_n,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_extend,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_insert_range,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_insert_ordered,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_erase_range,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test(test_remove_if),
+        cmocka_unit_test(test_sort),
+        cmocka_unit_test_setup_teardown(
+            test_sort_big,
+            at_init_big,
+            at_finish
+        ),
+        cmocka_unit_test(test_radix_sort),
+        cmocka_unit_test_setup_teardown(
+            test_bounds,
+            at_init_big,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_simd,
+            at_init_big,
+            at_finish
+        ),
+        cmocka_unit_test(test_parallel),
+        cmocka_unit_test(test_parallel_sort),
         cmocka_unit_test_setup_teardown(
             test_fetch,
             at_init,
             at_finish
         ),
+        cmocka_unit_test(test_growth),
+        cmocka_unit_test(test_reserved),
+        cmocka_unit_test(test_mmap),
         cmocka_unit_test_setup_teardown(
             test_indices,
             at_init,
@@ -297,6 +1041,31 @@ int main(void) {
             at_init,
             at_finish
         ),
+        cmocka_unit_test_setup_teardown(
+            test_iterator_static,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iterator_batch,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_foreach,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iterator_range,
+            at_init,
+            at_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_unchecked_access,
+            at_init,
+            at_finish
+        ),
         cmocka_unit_test_setup_teardown(
             test_remove,
             at_init,
@@ -327,7 +1096,8 @@ int main(void) {
             test_swap_big,
             at_init_big,
             at_finish
-        )
+        ),
+        cmocka_unit_test(test_swap_sizes)
     };
 
     int r = cmocka_run_group_tests(tests, NULL, NULL);
@@ -64,9 +64,32 @@ static void test_contains(void **state) {
     assert_true(bitmap_contains(uut, 5));
 }
 
+static void test_next(void **state) {
+    // spans whole words as well as the byte-wise tail
+    bitmap_t *uut = create_bitmap(200);
+    size_t keys[] = {0, 7, 8, 63, 64, 130, 199};
+    size_t found = 0;
+    for(int i = 0; i < 7; i++) {
+        bitmap_add(uut, keys[i]);
+    }
+    for(size_t key = bitmap_next(uut, 0, 200); key < 200;
+            key = bitmap_next(uut, key + 1, 200)) {
+        assert_int_equal(key, keys[found++]);
+    }
+    assert_int_equal(found, 7);
+    assert_int_equal(bitmap_next(uut, 9, 200), 63);
+    assert_int_equal(bitmap_next(uut, 65, 200), 130);
+    // keys at or beyond the limit are not reported
+    assert_int_equal(bitmap_next(uut, 65, 130), 130);
+    assert_int_equal(bitmap_next(uut, 131, 199), 199);
+    assert_int_equal(bitmap_next(uut, 200, 200), 200);
+    bitmap_free(uut);
+}
+
 int main(int argc, char **argv) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_min_capacity),
+        cmocka_unit_test(test_next),
         cmocka_unit_test_setup_teardown(
             test_add,
             bm_init,
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <alibc/containers/deque.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+struct wide {
+    int64_t a;
+    int64_t b;
+    int64_t c;
+};
+
+static int deque_init(void **state) {
+    // small blocks, to cross block boundaries often
+    deque_t *uut = create_deque(4, sizeof(int));
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int deque_finish(void **state) {
+    deque_free((deque_t*)*state);
+    return 0;
+}
+
+static void test_push_back(void **state) {
+    deque_t *uut = *state;
+    for(int i = 0; i < 100; i++) {
+        assert_int_equal(deque_push_back(uut, (void*)(intptr_t)i),
+                ALC_DEQUE_SUCCESS);
+    }
+    assert_int_equal(deque_size(uut), 100);
+    assert_int_equal(uut->nblocks, 25);
+    for(int i = 0; i < 100; i++) {
+        assert_int_equal(*(int*)deque_fetch(uut, i), i);
+    }
+}
+
+static void test_push_front(void **state) {
+    deque_t *uut = *state;
+    for(int i = 0; i < 50; i++) {
+        deque_push_front(uut, (void*)(intptr_t)i);
+        deque_push_back(uut, (void*)(intptr_t)(100 + i));
+    }
+    assert_int_equal(deque_size(uut), 100);
+    for(int i = 0; i < 50; i++) {
+        assert_int_equal(*(int*)deque_fetch(uut, i), 49 - i);
+        assert_int_equal(*(int*)deque_at_unchecked(uut, 50 + i), 100 + i);
+    }
+}
+
+static void test_pop(void **state) {
+    deque_t *uut = *state;
+    for(int i = 0; i < 10; i++) {
+        deque_push_back(uut, (void*)(intptr_t)i);
+    }
+    assert_int_equal(*(int*)deque_pop_front(uut), 0);
+    assert_int_equal(*(int*)deque_pop_back(uut), 9);
+    assert_int_equal(*(int*)deque_pop_front(uut), 1);
+    assert_int_equal(*(int*)deque_pop_front(uut), 2);
+    assert_int_equal(*(int*)deque_pop_front(uut), 3);
+    // the first block has been emptied and kept as the spare
+    assert_non_null(uut->spare);
+    assert_int_equal(deque_size(uut), 5);
+    assert_int_equal(*(int*)deque_fetch(uut, 0), 4);
+    while(deque_size(uut) > 0) {
+        deque_pop_back(uut);
+    }
+    assert_int_equal(uut->nblocks, 0);
+    assert_null(deque_pop_back(uut));
+    assert_null(deque_pop_front(uut));
+    assert_int_equal(deque_status(uut), ALC_DEQUE_IDX_OOB);
+
+    // usable again once emptied
+    deque_push_front(uut, (void*)7);
+    assert_int_equal(*(int*)deque_pop_back(uut), 7);
+}
+
+static void test_queue(void **state) {
+    deque_t *uut = *state;
+    int next = 0;
+    // a sliding window which walks through many blocks
+    for(int i = 0; i < 1000; i++) {
+        deque_push_back(uut, (void*)(intptr_t)i);
+        if(i % 3 != 0) {
+            assert_int_equal(*(int*)deque_pop_front(uut), next++);
+        }
+    }
+    assert_int_equal(deque_size(uut), 1000 - next);
+    assert_true(uut->nblocks <= (1000 - next) / 4 + 2);
+}
+
+static void test_stable(void **state) {
+    deque_t *uut = *state;
+    deque_push_back(uut, (void*)42);
+    int *first = (int*)deque_fetch(uut, 0);
+    for(int i = 0; i < 10000; i++) {
+        deque_push_back(uut, (void*)(intptr_t)i);
+        deque_push_front(uut, (void*)(intptr_t)i);
+    }
+    assert_ptr_equal(deque_fetch(uut, 10000), first);
+    assert_int_equal(*first, 42);
+}
+
+static void test_wide(void **state) {
+    deque_t *uut = create_deque(0, sizeof(struct wide));
+    assert_non_null(uut);
+    assert_int_equal(uut->block_elems, 256);
+    for(int64_t i = 0; i < 600; i++) {
+        struct wide item = {i, -i, i*i};
+        deque_push_front(uut, &item);
+    }
+    struct wide *item = (struct wide*)deque_fetch(uut, 0);
+    assert_int_equal(item->a, 599);
+    assert_int_equal(item->c, 599*599);
+    item = (struct wide*)deque_pop_back(uut);
+    assert_int_equal(item->b, 0);
+    deque_free(uut);
+}
+
+static void test_invalid_calls(void **state) {
+    deque_t *uut = *state;
+    assert_null(deque_fetch(uut, 0));
+    assert_int_equal(deque_status(uut), ALC_DEQUE_IDX_OOB);
+    assert_null(create_deque(4, 0));
+    assert_int_equal(deque_push_back(NULL, NULL), ALC_DEQUE_INVALID);
+    assert_int_equal(deque_push_front(NULL, NULL), ALC_DEQUE_INVALID);
+    assert_null(deque_pop_back(NULL));
+    assert_null(deque_pop_front(NULL));
+    assert_null(deque_fetch(NULL, 0));
+    assert_int_equal(deque_size(NULL), -1);
+    assert_int_equal(deque_status(NULL), ALC_DEQUE_INVALID);
+    deque_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_push_back,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_push_front,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_pop,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_queue,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_stable,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test(test_wide),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            deque_init,
+            deque_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
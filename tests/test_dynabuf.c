@@ -1,7 +1,10 @@
 #include <alibc/containers/dynabuf.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
@@ -35,6 +38,183 @@ static void test_resize(void **state) {
     assert_int_equal(*(int*)dynabuf_fetch(uut, 19), 19);
 }
 
+static void test_grow_count(void **state) {
+    dynabuf_t *uut = *state;
+    // capacity is 3 elements
+    assert_int_equal(dynabuf_grow_count(uut, 4), 7);
+    assert_int_equal(dynabuf_grow_count(uut, 100), 100);
+
+    assert_int_equal(dynabuf_set_growth(uut, ALC_DYNABUF_GROW_HALF),
+            ALC_DYNABUF_SUCCESS);
+    assert_int_equal(dynabuf_grow_count(uut, 4), 5);
+
+    dynabuf_set_growth(uut, ALC_DYNABUF_GROW_PAGE);
+    assert_int_equal(dynabuf_grow_count(uut, 4),
+            ALC_DYNABUF_PAGE_SIZE/sizeof(int));
+
+    assert_int_equal(dynabuf_set_growth(uut, -1), ALC_DYNABUF_INVALID);
+    assert_int_equal(dynabuf_grow_count(NULL, 4), 0);
+}
+
+static void test_overflow(void **state) {
+    assert_null(create_dynabuf(SIZE_MAX, 2));
+    dynabuf_t *uut = *state;
+    assert_int_equal(dynabuf_resize(uut, SIZE_MAX), ALC_DYNABUF_NO_MEM);
+    // the original buffer is left untouched
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 1), 2);
+}
+
+static void test_reserved(void **state) {
+    dynabuf_t *uut = create_dynabuf_reserved(4, sizeof(int), 1 << 20);
+    assert_non_null(uut);
+    assert_int_equal(uut->mode, ALC_DYNABUF_RESERVED);
+    char *base = uut->buf;
+    dynabuf_set(uut, 3, 3);
+
+    // growth within the reservation never moves the buffer
+    for(size_t count = 8; count <= (1 << 20); count *= 2) {
+        assert_int_equal(dynabuf_resize(uut, count), ALC_DYNABUF_SUCCESS);
+        assert_ptr_equal(uut->buf, base);
+        dynabuf_set(uut, count - 1, (void*)(intptr_t)count);
+    }
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 3), 3);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, (1 << 20) - 1), 1 << 20);
+
+    assert_int_equal(dynabuf_resize(uut, (1 << 20) + 1), ALC_DYNABUF_NO_MEM);
+    assert_int_equal(dynabuf_grow_count(uut, 5), 1 << 20);
+
+    // shrinking keeps the retained prefix intact
+    assert_int_equal(dynabuf_resize(uut, 16), ALC_DYNABUF_SUCCESS);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 3), 3);
+    dynabuf_free(uut);
+
+    // nothing committed up front
+    uut = create_dynabuf_reserved(0, sizeof(int), 16);
+    assert_non_null(uut);
+    assert_int_equal(dynabuf_resize(uut, 16), ALC_DYNABUF_SUCCESS);
+    dynabuf_free(uut);
+
+    assert_null(create_dynabuf_reserved(8, sizeof(int), 4));
+    assert_null(create_dynabuf_reserved(8, 0, 16));
+}
+
+static void test_mmap(void **state) {
+    char path[] = "/tmp/alc_test_dynabuf_XXXXXX";
+    int fd = mkstemp(path);
+    assert_true(fd >= 0);
+    close(fd);
+
+    dynabuf_t *uut = create_dynabuf_mmap(path, 4, sizeof(int), 16);
+    assert_non_null(uut);
+    assert_int_equal(uut->mode, ALC_DYNABUF_MAPPED);
+    assert_int_equal(uut->capacity, 4*sizeof(int));
+    strcpy(dynabuf_header(uut), "header");
+    dynabuf_set(uut, 1, 11);
+    assert_int_equal(dynabuf_resize(uut, 1000), ALC_DYNABUF_SUCCESS);
+    dynabuf_set(uut, 999, 999);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 1), 11);
+    assert_int_equal(dynabuf_flush(uut), ALC_DYNABUF_SUCCESS);
+    dynabuf_free(uut);
+
+    // reopening keeps the contents and the full size of the file
+    uut = create_dynabuf_mmap(path, 4, sizeof(int), 16);
+    assert_non_null(uut);
+    assert_int_equal(uut->capacity, 1000*sizeof(int));
+    assert_true(strcmp(dynabuf_header(uut), "header") == 0);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 1), 11);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 999), 999);
+
+    // shrinking truncates the file
+    assert_int_equal(dynabuf_resize(uut, 2), ALC_DYNABUF_SUCCESS);
+    dynabuf_free(uut);
+    struct stat st;
+    stat(path, &st);
+    assert_int_equal(st.st_size, 16 + 2*sizeof(int));
+    unlink(path);
+
+    // a partial trailing element is padded out rather than left unmapped
+    strcpy(path, "/tmp/alc_test_dynabuf_XXXXXX");
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    char bytes[16 + 4*sizeof(int) + 3];
+    memset(bytes, 7, sizeof(bytes));
+    assert_int_equal(write(fd, bytes, sizeof(bytes)), sizeof(bytes));
+    close(fd);
+    uut = create_dynabuf_mmap(path, 1, sizeof(int), 16);
+    assert_non_null(uut);
+    assert_int_equal(uut->capacity, 5*sizeof(int));
+    assert_true(memcmp(dynabuf_at(uut, 4), bytes, 3) == 0);
+    assert_int_equal(((char*)dynabuf_at(uut, 4))[3], 0);
+    stat(path, &st);
+    assert_int_equal(st.st_size, 16 + 5*sizeof(int));
+    assert_int_equal(dynabuf_flush(uut), ALC_DYNABUF_SUCCESS);
+    assert_int_equal(dynabuf_resize(uut, 8), ALC_DYNABUF_SUCCESS);
+    dynabuf_free(uut);
+    unlink(path);
+
+    assert_null(create_dynabuf_mmap(NULL, 4, sizeof(int), 0));
+    assert_null(create_dynabuf_mmap("/nonexistent/dir/file", 4, 4, 0));
+    assert_null(dynabuf_header(*state));
+    assert_int_equal(dynabuf_flush(*state), ALC_DYNABUF_SUCCESS);
+}
+
+static void test_aligned(void **state) {
+    dynabuf_t *uut = create_dynabuf_aligned(3, sizeof(int),
+            ALC_DYNABUF_ALIGN_CACHELINE);
+    assert_non_null(uut);
+    assert_int_equal((uintptr_t)uut->buf % ALC_DYNABUF_ALIGN_CACHELINE, 0);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 2), 0);
+    dynabuf_set(uut, 2, 42);
+    // alignment survives growth
+    assert_int_equal(dynabuf_resize(uut, 5000), ALC_DYNABUF_SUCCESS);
+    assert_int_equal((uintptr_t)uut->buf % ALC_DYNABUF_ALIGN_CACHELINE, 0);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 2), 42);
+    dynabuf_free(uut);
+
+    uut = create_dynabuf_aligned(16, sizeof(int), ALC_DYNABUF_ALIGN_HUGE);
+    assert_non_null(uut);
+    assert_int_equal((uintptr_t)uut->buf % ALC_DYNABUF_ALIGN_HUGE, 0);
+    dynabuf_set(uut, 15, 15);
+    assert_int_equal(*(int*)dynabuf_fetch(uut, 15), 15);
+    dynabuf_free(uut);
+
+    // 0 falls back to malloc alignment
+    uut = create_dynabuf_aligned(4, sizeof(int), 0);
+    assert_non_null(uut);
+    assert_int_equal(uut->align, 0);
+    dynabuf_free(uut);
+
+    assert_null(create_dynabuf_aligned(4, sizeof(int), 48));
+    assert_null(create_dynabuf_aligned(4, sizeof(int), 2));
+    assert_null(create_dynabuf_aligned(SIZE_MAX, 8, 64));
+}
+
+static void test_borrowed(void **state) {
+    int storage[4] = {1, 2, 3, 4};
+    dynabuf_t uut;
+    assert_int_equal(dynabuf_init(&uut, storage, 4, sizeof(int)),
+            ALC_DYNABUF_SUCCESS);
+    assert_int_equal(uut.mode, ALC_DYNABUF_BORROWED);
+    dynabuf_set(&uut, 2, 30);
+    assert_int_equal(storage[2], 30);
+
+    // the first resize moves the contents to the heap
+    assert_int_equal(dynabuf_resize(&uut, 16), ALC_DYNABUF_SUCCESS);
+    assert_int_equal(uut.mode, ALC_DYNABUF_HEAP);
+    assert_true(uut.buf != (char*)storage);
+    assert_int_equal(*(int*)dynabuf_fetch(&uut, 2), 30);
+    dynabuf_set(&uut, 2, 3);
+    assert_int_equal(storage[2], 30);
+    dynabuf_release(&uut);
+    assert_null(uut.buf);
+
+    assert_int_equal(dynabuf_init(NULL, storage, 4, sizeof(int)),
+            ALC_DYNABUF_INVALID);
+    assert_int_equal(dynabuf_init(&uut, NULL, 4, sizeof(int)),
+            ALC_DYNABUF_INVALID);
+    assert_int_equal(dynabuf_init(&uut, storage, 4, 0), ALC_DYNABUF_INVALID);
+}
+
 static void test_set(void **state) {
     dynabuf_t *uut = *state;
     assert_int_equal(*(int*)dynabuf_fetch(uut, 0), 1);
@@ -44,6 +224,13 @@ static void test_set(void **state) {
     assert_int_equal(*(int*)dynabuf_fetch(uut, 0), 3);
 }
 
+static void test_at(void **state) {
+    dynabuf_t *uut = *state;
+    assert_ptr_equal(dynabuf_at(uut, 0), dynabuf_fetch(uut, 0));
+    assert_ptr_equal(dynabuf_at(uut, 2), dynabuf_fetch(uut, 2));
+    assert_int_equal(*(int*)dynabuf_at(uut, 1), 2);
+}
+
 static void test_set_big(void **state) {
     dynabuf_t *uut = *state;
     struct test t1 = {.a = "test", .b = "string"};
@@ -135,6 +322,29 @@ int main(void) {
             init,
             finish
         ),
+        cmocka_unit_test_setup_teardown(
+            test_at,
+            init,
+            finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_grow_count,
+            init,
+            finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_overflow,
+            init,
+            finish
+        ),
+        cmocka_unit_test(test_reserved),
+        cmocka_unit_test(test_aligned),
+        cmocka_unit_test(test_borrowed),
+        cmocka_unit_test_setup_teardown(
+            test_mmap,
+            init,
+            finish
+        ),
         cmocka_unit_test_setup_teardown(
             test_invalid_calls,
             init,
@@ -32,7 +32,7 @@ static int ht_finish(void **state)    {
     return 0;
 }
 
-static bool full_load(int entries, int capacity) {
+static bool full_load(size_t entries, size_t capacity) {
     return entries >= capacity;
 }
 
@@ -79,6 +79,7 @@ static void test_remove(void **state) {
         assert_int_equal(result, i + 1);
     }
     assert_null(hashmap_remove(uut, "two hundred twenty one"));
+    assert_int_equal(hashmap_size(uut), 0);
 
     for(int i = 0; i < 10; i++) {
         // careful not to deref null...
@@ -104,6 +105,93 @@ static void test_resize(void **state) {
     assert_int_equal(result, ALC_HASHMAP_SUCCESS);
 }
 
+static uint32_t hash_identity(void *key) {
+    return (uint32_t)(uintptr_t)key;
+}
+
+static uint32_t hash_seven(void *key) {
+    return 7;
+}
+
+static void test_rehash(void **state) {
+    // entries are rehashed by their key, not by the address of their slot
+    hashmap_t *uut = create_hashmap(8, sizeof(int64_t), sizeof(int64_t),
+            hash_identity, alc_default_cmp_i64, NULL);
+    hashmap_set(uut, (void*)5, (void*)50);
+    assert_int_equal(hashmap_resize(uut, 32), ALC_HASHMAP_SUCCESS);
+    assert_true(bitmap_contains(uut->_filter, 5));
+    assert_int_equal(*(int64_t*)hashmap_fetch(uut, (void*)5), 50);
+    hashmap_free(uut);
+
+    // collisions are probed through the whole of the new table
+    uut = create_hashmap(8, sizeof(int64_t), sizeof(int64_t),
+            hash_seven, alc_default_cmp_i64, NULL);
+    hashmap_set(uut, (void*)1, (void*)10);
+    hashmap_set(uut, (void*)2, (void*)20);
+    assert_int_equal(hashmap_resize(uut, 16), ALC_HASHMAP_SUCCESS);
+    assert_true(bitmap_contains(uut->_filter, 7));
+    assert_true(bitmap_contains(uut->_filter, 8));
+    assert_false(bitmap_contains(uut->_filter, 0));
+    hashmap_free(uut);
+}
+
+static void test_remove_gap(void **state) {
+    // three colliding keys fill slots 7, 8 and 9
+    hashmap_t *uut = create_hashmap(16, sizeof(int64_t), sizeof(int64_t),
+            hash_seven, alc_default_cmp_i64, NULL);
+    for(int64_t i = 1; i <= 3; i++) {
+        hashmap_set(uut, (void*)i, (void*)(i*10));
+    }
+    // setting a key found beyond a removed entry updates it in place
+    hashmap_remove(uut, (void*)1);
+    assert_int_equal(hashmap_set(uut, (void*)3, (void*)33),
+            ALC_HASHMAP_SUCCESS);
+    assert_int_equal(hashmap_size(uut), 2);
+    assert_int_equal(*(int64_t*)hashmap_fetch(uut, (void*)3), 33);
+    // a new key takes the removed slot
+    hashmap_set(uut, (void*)4, (void*)40);
+    assert_true(bitmap_contains(uut->_filter, 7));
+    assert_false(bitmap_contains(uut->_filter, 10));
+    assert_int_equal(uut->removed, 0);
+    assert_null(hashmap_fetch(uut, (void*)1));
+    hashmap_free(uut);
+
+    // churn clears out removed entries instead of growing the table
+    uut = create_hashmap(16, sizeof(int64_t), sizeof(int64_t),
+            alc_default_hash_i64, alc_default_cmp_i64, NULL);
+    for(int64_t i = 0; i < 1000; i++) {
+        hashmap_set(uut, (void*)i, (void*)i);
+        if(i >= 4) {
+            assert_non_null(hashmap_remove(uut, (void*)(i - 4)));
+        }
+    }
+    assert_int_equal(hashmap_size(uut), 4);
+    assert_int_equal(uut->capacity, 16);
+    for(int64_t i = 996; i < 1000; i++) {
+        assert_int_equal(*(int64_t*)hashmap_fetch(uut, (void*)i), i);
+    }
+    hashmap_free(uut);
+}
+
+static void test_huge_table(void **state) {
+    // large enough to cross ALC_DYNABUF_HUGE_THRESHOLD
+    size_t count = ALC_DYNABUF_HUGE_THRESHOLD / (2*sizeof(uint64_t));
+    hashmap_t *uut = create_hashmap(
+        count, sizeof(uint64_t), sizeof(uint64_t),
+        alc_default_hash_i64, alc_default_cmp_i64, NULL
+    );
+    assert_non_null(uut);
+    assert_int_equal(uut->map->align, ALC_DYNABUF_ALIGN_HUGE);
+    assert_int_equal((uintptr_t)uut->map->buf % ALC_DYNABUF_ALIGN_HUGE, 0);
+    for(uint64_t i = 0; i < 100; i++) {
+        hashmap_set(uut, (void*)i, (void*)(i*3));
+    }
+    for(uint64_t i = 0; i < 100; i++) {
+        assert_int_equal(*(uint64_t*)hashmap_fetch(uut, (void*)i), i*3);
+    }
+    hashmap_free(uut);
+}
+
 static void test_size(void **state) {
     hashmap_t *uut = *state;
     int size = hashmap_size(uut);
@@ -174,6 +262,155 @@ static void test_iter_values(void **state) {
     bitmap_free(values_bmp);
 }
 
+static void test_iter_static(void **state) {
+    hashmap_t *uut = *state;
+    iter_context keys;
+    iter_context values;
+    int count = 0;
+    assert_int_equal(iter_init_hashmap_keys(NULL, uut), ALC_ITER_NULL);
+    assert_int_equal(iter_init_hashmap_values(&values, NULL),
+            ALC_ITER_INVALID);
+    assert_null(iter_next(&values));
+    assert_int_equal(iter_status(&values), ALC_ITER_INVALID);
+
+    // keys and values walk the map in the same order
+    assert_int_equal(iter_init_hashmap_keys(&keys, uut), ALC_ITER_READY);
+    assert_int_equal(iter_init_hashmap_values(&values, uut), ALC_ITER_READY);
+    for(void **key = iter_next(&keys); key != NULL; key = iter_next(&keys)) {
+        void **value = iter_next(&values);
+        assert_non_null(value);
+        assert_int_equal(*(int*)hashmap_fetch(uut, *key), *(int*)value);
+        count++;
+    }
+    assert_int_equal(count, 10);
+    iter_free(&keys);
+    iter_free(&values);
+}
+
+static void test_iter_batch(void **state) {
+    hashmap_t *uut = *state;
+    iter_context keys;
+    iter_context values;
+    void **key_batch[3];
+    void **value_batch[3];
+    int count = 0;
+    int n;
+    iter_init_hashmap_keys(&keys, uut);
+    iter_init_hashmap_values(&values, uut);
+    while((n = iter_next_batch(&keys, (void**)key_batch, 3)) > 0) {
+        assert_int_equal(iter_next_batch(&values, (void**)value_batch, 3), n);
+        for(int i = 0; i < n; i++) {
+            assert_int_equal(*(int*)hashmap_fetch(uut, *key_batch[i]),
+                    *(int*)value_batch[i]);
+        }
+        count += n;
+    }
+    assert_int_equal(count, 10);
+    assert_int_equal(iter_status(&keys), ALC_ITER_STOP);
+    assert_int_equal(iter_next_batch(&values, (void**)value_batch, 3), 0);
+}
+
+static void test_foreach(void **state) {
+    hashmap_t *uut = *state;
+    void **key;
+    void **val;
+    int count = 0;
+    int sum = 0;
+    ALC_HASHMAP_FOREACH(uut, key, val) {
+        assert_ptr_equal(hashmap_fetch(uut, *key), val);
+        sum += *(int*)val;
+        count++;
+    }
+    assert_int_equal(count, 10);
+    assert_int_equal(sum, 55);
+}
+
+static void test_iter_entries(void **state) {
+    hashmap_t *uut = *state;
+    iter_context *iter = create_hashmap_entries_iterator(uut);
+    hashmap_entries_iter_t entries;
+    void *batch[32];
+    int count = 0;
+    int n;
+    assert_non_null(iter);
+    for(hashmap_entry_t *entry = (hashmap_entry_t*)iter_next(iter);
+            entry != NULL; entry = (hashmap_entry_t*)iter_next(iter)) {
+        assert_ptr_equal(hashmap_fetch(uut, *entry->key), entry->value);
+        count++;
+    }
+    assert_int_equal(count, 10);
+    assert_int_equal(iter_status(iter), ALC_ITER_STOP);
+    iter_free(iter);
+
+    // batches are capped at ALC_HASHMAP_ENTRY_BATCH
+    static char extra[20][8];
+    for(uint64_t i = 0; i < 20; i++) {
+        snprintf(extra[i], sizeof(extra[i]), "key %d", (int)i);
+        hashmap_set(uut, extra[i], (void*)(i + 11));
+    }
+    count = 0;
+    assert_int_equal(iter_init_hashmap_entries(&entries, uut), ALC_ITER_READY);
+    while((n = iter_next_batch(&entries.ctx, batch, 32)) > 0) {
+        assert_true(n <= ALC_HASHMAP_ENTRY_BATCH);
+        for(int i = 0; i < n; i++) {
+            hashmap_entry_t *entry = batch[i];
+            assert_ptr_equal(hashmap_fetch(uut, *entry->key), entry->value);
+        }
+        count += n;
+    }
+    assert_int_equal(count, hashmap_size(uut));
+    iter_free(&entries.ctx);
+
+    assert_int_equal(iter_init_hashmap_entries(NULL, uut), ALC_ITER_NULL);
+    assert_int_equal(iter_init_hashmap_entries(&entries, NULL),
+            ALC_ITER_INVALID);
+    assert_int_equal(iter_next_batch(&entries.ctx, batch, 32), -1);
+}
+
+static void test_iter_range(void **state) {
+    hashmap_t *uut = *state;
+    iter_context parts[4];
+    size_t bounds[5];
+    int count = 0;
+    int sum = 0;
+    iter_context *iter = create_hashmap_values_iterator(uut);
+    assert_int_equal(iter_split(iter, parts, 4), 4);
+    for(int i = 0; i < 4; i++) {
+        bounds[i] = parts[i].index;
+        bounds[i + 1] = parts[i].end;
+        for(void **val = iter_next(&parts[i]); val != NULL;
+                val = iter_next(&parts[i])) {
+            sum += *(int*)val;
+            count++;
+        }
+    }
+    assert_int_equal(count, 10);
+    assert_int_equal(sum, 55);
+    iter_free(iter);
+
+    // keys and entries over the same slots agree
+    count = 0;
+    for(int i = 0; i < 4; i++) {
+        iter_context *keys = create_hashmap_keys_iterator_range(uut,
+                bounds[i], bounds[i + 1]);
+        iter_context *entries = create_hashmap_entries_iterator_range(uut,
+                bounds[i], bounds[i + 1]);
+        for(void **key = iter_next(keys); key != NULL; key = iter_next(keys)) {
+            hashmap_entry_t *entry = (hashmap_entry_t*)iter_next(entries);
+            assert_non_null(entry);
+            assert_ptr_equal(entry->key, key);
+            count++;
+        }
+        assert_null(iter_next(entries));
+        // entries iterators are partitioned by range, not split
+        assert_int_equal(iter_split(entries, parts, 2), -1);
+        iter_free(keys);
+        iter_free(entries);
+    }
+    assert_int_equal(count, 10);
+    assert_null(create_hashmap_keys_iterator_range(uut, 1, 0));
+}
+
 static void test_invalid_calls(void **state) {
     // test all check_valid/check_space_available calls with NULL self
     int r = hashmap_set(NULL, "key", 0);
@@ -191,8 +428,12 @@ static void test_invalid_calls(void **state) {
     r = hashmap_fetch(NULL, "key");
     assert_null(r);
 
-    // test null bitmap
+    // test null bitmaps
     hashmap_t *uut = *state;
+    bitmap_free(uut->_removed);
+    uut->_removed = NULL;
+    r = hashmap_set(uut, "key", 0);
+    assert_int_equal(r, ALC_HASHMAP_INVALID);
     bitmap_free(uut->_filter);
     uut->_filter = NULL;
     r = hashmap_set(uut, "key", 0);
@@ -236,6 +477,9 @@ int main(int argc, char **argv) {
             ht_init,
             ht_finish
         ),
+        cmocka_unit_test(test_rehash),
+        cmocka_unit_test(test_remove_gap),
+        cmocka_unit_test(test_huge_table),
         cmocka_unit_test_setup_teardown(
             test_iter_keys,
             ht_init,
@@ -246,6 +490,31 @@ int main(int argc, char **argv) {
             ht_init,
             ht_finish
         ),
+        cmocka_unit_test_setup_teardown(
+            test_iter_static,
+            ht_init,
+            ht_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iter_batch,
+            ht_init,
+            ht_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_foreach,
+            ht_init,
+            ht_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iter_entries,
+            ht_init,
+            ht_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iter_range,
+            ht_init,
+            ht_finish
+        ),
         cmocka_unit_test_setup_teardown(
             test_size,
             ht_init,
@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/heap.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+static int8_t cmp_int(void *a, void *b) {
+    int x = (int)(intptr_t)a;
+    int y = (int)(intptr_t)b;
+    return (x > y) - (x < y);
+}
+
+// larger than a pointer, so elements are passed by address
+struct node {
+    int64_t id;
+    int64_t dist;
+    char pad[8];
+};
+
+static int8_t cmp_dist(void *a, void *b) {
+    int64_t x = ((struct node*)a)->dist;
+    int64_t y = ((struct node*)b)->dist;
+    return (x > y) - (x < y);
+}
+
+static int8_t eq_id(void *a, void *b) {
+    return ((struct node*)a)->id != ((struct node*)b)->id;
+}
+
+static uint32_t hash_id(void *a) {
+    return (uint32_t)(((struct node*)a)->id * 2654435761u);
+}
+
+static int heap_init(void **state) {
+    heap_t *uut = create_heap(4, sizeof(int), 4, cmp_int);
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int heap_finish(void **state) {
+    heap_free((heap_t*)*state);
+    return 0;
+}
+
+static void test_push_pop(void **state) {
+    heap_t *uut = *state;
+    assert_null(heap_pop(uut));
+    assert_int_equal(heap_status(uut), ALC_HEAP_EMPTY);
+    assert_null(heap_peek(uut));
+
+    srand(7);
+    for(int i = 0; i < 500; i++) {
+        assert_int_equal(heap_push(uut, (void*)(intptr_t)(rand() % 1000)),
+                ALC_HEAP_SUCCESS);
+    }
+    assert_int_equal(heap_size(uut), 500);
+    int prev = -1;
+    for(int i = 0; i < 500; i++) {
+        int top = *(int*)heap_peek(uut);
+        int popped = *(int*)heap_pop(uut);
+        assert_int_equal(top, popped);
+        assert_true(popped >= prev);
+        prev = popped;
+    }
+    assert_int_equal(heap_size(uut), 0);
+}
+
+static void test_binary_records(void **state) {
+    heap_t *uut = create_heap(1, sizeof(struct node), 2, cmp_dist);
+    assert_non_null(uut);
+    for(int64_t i = 0; i < 100; i++) {
+        struct node n = {i, (i * 37) % 100};
+        heap_push(uut, &n);
+    }
+    for(int64_t i = 0; i < 100; i++) {
+        struct node *n = (struct node*)heap_pop(uut);
+        assert_int_equal(n->dist, i);
+        assert_int_equal((n->id * 37) % 100, i);
+    }
+    heap_free(uut);
+}
+
+static void test_from_array(void **state) {
+    array_t *src = create_array(1, sizeof(int));
+    for(int i = 0; i < 1000; i++) {
+        array_append(src, (void*)(intptr_t)((i * 7919) % 1000));
+    }
+    heap_t *uut = create_heap_from_array(src, 4, cmp_int);
+    assert_non_null(uut);
+    // the source is copied, not reordered
+    assert_int_equal(*(int*)array_fetch(src, 1), 919);
+    array_free(src);
+
+    assert_int_equal(heap_size(uut), 1000);
+    for(int i = 0; i < 1000; i++) {
+        assert_int_equal(*(int*)heap_pop(uut), i);
+    }
+    heap_free(uut);
+}
+
+static void test_replace_top(void **state) {
+    heap_t *uut = *state;
+    int values[] = {5, 3, 8, 1};
+    for(int i = 0; i < 4; i++) {
+        heap_push(uut, (void*)(intptr_t)values[i]);
+    }
+    // keep the three largest of a stream, as in a top-k query
+    for(int v = 0; v < 20; v += 3) {
+        if(v > *(int*)heap_peek(uut)) {
+            heap_replace_top(uut, (void*)(intptr_t)v);
+        }
+    }
+    int expect[] = {12, 15, 18};
+    heap_pop(uut);
+    for(int i = 0; i < 3; i++) {
+        assert_int_equal(*(int*)heap_pop(uut), expect[i]);
+    }
+    assert_null(heap_replace_top(uut, (void*)1));
+    assert_int_equal(heap_status(uut), ALC_HEAP_EMPTY);
+}
+
+static void test_indexed(void **state) {
+    heap_t *uut = create_heap_indexed(4, sizeof(struct node), 4, cmp_dist,
+            hash_id, eq_id);
+    assert_non_null(uut);
+    for(int64_t i = 0; i < 50; i++) {
+        struct node n = {i, 1000 + i};
+        assert_int_equal(heap_push(uut, &n), ALC_HEAP_SUCCESS);
+    }
+
+    // decrease the keys of the odd ids below every even id
+    for(int64_t i = 1; i < 50; i += 2) {
+        struct node old = {i, 0};
+        struct node n = {i, i};
+        assert_int_equal(heap_update(uut, &old, &n), ALC_HEAP_SUCCESS);
+    }
+    // and increase one key past everything
+    struct node old = {0, 0};
+    struct node last = {0, 5000};
+    assert_int_equal(heap_update(uut, &old, &last), ALC_HEAP_SUCCESS);
+    struct node missing = {77, 0};
+    assert_int_equal(heap_update(uut, &missing, &last), ALC_HEAP_NOT_FOUND);
+    assert_int_equal(heap_size(uut), 50);
+
+    for(int64_t i = 1; i < 50; i += 2) {
+        assert_int_equal(((struct node*)heap_pop(uut))->id, i);
+    }
+    for(int64_t i = 2; i < 50; i += 2) {
+        assert_int_equal(((struct node*)heap_pop(uut))->id, i);
+    }
+    assert_int_equal(((struct node*)heap_pop(uut))->id, 0);
+    assert_int_equal(uut->positions->entries, 0);
+    heap_free(uut);
+}
+
+static void test_indexed_random(void **state) {
+    int64_t dist[200];
+    heap_t *uut = create_heap_indexed(8, sizeof(struct node), 2, cmp_dist,
+            hash_id, eq_id);
+    assert_non_null(uut);
+    srand(11);
+    for(int64_t i = 0; i < 200; i++) {
+        struct node n = {i, dist[i] = rand() % 10000};
+        heap_push(uut, &n);
+    }
+    // interleave updates in both directions with pops
+    for(int round = 0; round < 2000; round++) {
+        int64_t id = rand() % 200;
+        if(dist[id] < 0) {
+            continue;
+        }
+        struct node old = {id, 0};
+        struct node n = {id, dist[id] = rand() % 10000};
+        assert_int_equal(heap_update(uut, &old, &n), ALC_HEAP_SUCCESS);
+        if(round % 20 == 0) {
+            struct node *top = (struct node*)heap_pop(uut);
+            assert_int_equal(top->dist, dist[top->id]);
+            dist[top->id] = -1;
+        }
+    }
+    int64_t prev = -1;
+    while(heap_size(uut) > 0) {
+        struct node *top = (struct node*)heap_pop(uut);
+        assert_int_equal(top->dist, dist[top->id]);
+        assert_true(top->dist >= prev);
+        prev = top->dist;
+    }
+    assert_int_equal(uut->positions->entries, 0);
+    heap_free(uut);
+}
+
+static void test_indexed_missing_position(void **state) {
+    heap_t *uut = create_heap_indexed(8, sizeof(struct node), 2, cmp_dist,
+            hash_id, eq_id);
+    assert_non_null(uut);
+    for(int64_t i = 0; i < 10; i++) {
+        struct node n = {i, i};
+        heap_push(uut, &n);
+    }
+    // a failed position update leaves an element without an entry, moving it
+    // later must restore the entry rather than crash.
+    struct node top = {0, 0};
+    hashmap_remove(uut->positions, &top);
+    struct node first = {10, -1};
+    assert_int_equal(heap_push(uut, &first), ALC_HEAP_SUCCESS);
+    assert_int_equal(uut->positions->entries, 11);
+    struct node moved = {0, 20};
+    assert_int_equal(heap_update(uut, &top, &moved), ALC_HEAP_SUCCESS);
+    assert_int_equal(((struct node*)heap_pop(uut))->id, 10);
+    for(int64_t i = 1; i < 10; i++) {
+        assert_int_equal(((struct node*)heap_pop(uut))->id, i);
+    }
+    assert_int_equal(((struct node*)heap_pop(uut))->id, 0);
+    assert_int_equal(uut->positions->entries, 0);
+    heap_free(uut);
+}
+
+static void test_invalid_calls(void **state) {
+    heap_t *uut = *state;
+    assert_null(create_heap(4, 0, 2, cmp_int));
+    assert_null(create_heap(4, 4, 1, cmp_int));
+    assert_null(create_heap(4, 4, 2, NULL));
+    assert_null(create_heap_indexed(4, 4, 2, cmp_int, NULL, cmp_int));
+    assert_null(create_heap_from_array(NULL, 2, cmp_int));
+    assert_int_equal(heap_push(NULL, NULL), ALC_HEAP_INVALID);
+    assert_null(heap_peek(NULL));
+    assert_null(heap_pop(NULL));
+    assert_null(heap_replace_top(NULL, NULL));
+    assert_int_equal(heap_update(NULL, NULL, NULL), ALC_HEAP_INVALID);
+    // only indexed heaps track positions
+    assert_int_equal(heap_update(uut, NULL, NULL), ALC_HEAP_INVALID_REQ);
+    assert_int_equal(heap_size(NULL), -1);
+    assert_int_equal(heap_status(NULL), ALC_HEAP_INVALID);
+    heap_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_push_pop,
+            heap_init,
+            heap_finish
+        ),
+        cmocka_unit_test(test_binary_records),
+        cmocka_unit_test(test_from_array),
+        cmocka_unit_test_setup_teardown(
+            test_replace_top,
+            heap_init,
+            heap_finish
+        ),
+        cmocka_unit_test(test_indexed),
+        cmocka_unit_test(test_indexed_random),
+        cmocka_unit_test(test_indexed_missing_position),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            heap_init,
+            heap_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
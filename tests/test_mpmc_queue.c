@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <alibc/containers/mpmc_queue.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define THREADS         4
+#define PER_PRODUCER    50000
+
+// larger than a pointer, so it is passed to push by address
+struct message {
+    uint64_t producer;
+    uint64_t seq;
+};
+
+struct consumer_result {
+    uint64_t count;
+    uint64_t sum;
+    int ordered;
+};
+
+static int queue_init(void **state) {
+    mpmc_queue_t *uut = create_mpmc_queue(6, sizeof(int));
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int queue_finish(void **state) {
+    mpmc_queue_free((mpmc_queue_t*)*state);
+    return 0;
+}
+
+static void test_push_pop(void **state) {
+    mpmc_queue_t *uut = *state;
+    int out;
+    // capacity is rounded up to a power of two
+    assert_int_equal(mpmc_queue_capacity(uut), 8);
+    assert_int_equal(mpmc_queue_try_pop(uut, &out), ALC_MPMC_QUEUE_EMPTY);
+
+    // wrap around the ring a few times
+    for(int round = 0; round < 5; round++) {
+        for(int i = 0; i < 8; i++) {
+            assert_int_equal(
+                mpmc_queue_try_push(uut, (void*)(intptr_t)(round*8 + i)),
+                ALC_MPMC_QUEUE_SUCCESS
+            );
+        }
+        assert_int_equal(mpmc_queue_try_push(uut, (void*)-1),
+                ALC_MPMC_QUEUE_FULL);
+        assert_int_equal(mpmc_queue_size(uut), 8);
+        for(int i = 0; i < 8; i++) {
+            assert_int_equal(mpmc_queue_pop(uut, &out), ALC_MPMC_QUEUE_SUCCESS);
+            assert_int_equal(out, round*8 + i);
+        }
+        assert_int_equal(mpmc_queue_try_pop(uut, &out), ALC_MPMC_QUEUE_EMPTY);
+        assert_int_equal(mpmc_queue_size(uut), 0);
+    }
+}
+
+static void test_batch(void **state) {
+    mpmc_queue_t *uut = *state;
+    int in[12];
+    int out[12];
+    for(int i = 0; i < 12; i++) {
+        in[i] = i * 3;
+    }
+    assert_int_equal(mpmc_queue_try_push_n(uut, in, 5), 5);
+    assert_int_equal(mpmc_queue_try_pop_n(uut, out, 5), 5);
+
+    // only as many as fit are pushed, across the end of the ring
+    assert_int_equal(mpmc_queue_try_push_n(uut, in, 12), 8);
+    assert_int_equal(mpmc_queue_try_push_n(uut, in, 1), 0);
+    memset(out, 0, sizeof(out));
+    assert_int_equal(mpmc_queue_try_pop_n(uut, out, 3), 3);
+    assert_int_equal(mpmc_queue_try_pop_n(uut, out + 3, 12), 5);
+    for(int i = 0; i < 8; i++) {
+        assert_int_equal(out[i], i * 3);
+    }
+    assert_int_equal(mpmc_queue_try_pop_n(uut, out, 12), 0);
+}
+
+static mpmc_queue_t *shared;
+
+static void *producer(void *arg) {
+    uint64_t id = (uintptr_t)arg;
+    struct message batch[3];
+    uint64_t next = 0;
+    while(next < PER_PRODUCER) {
+        // mix blocking single pushes with batches
+        if(next % 4 == 0) {
+            struct message msg = {id, next};
+            mpmc_queue_push(shared, &msg);
+            next++;
+        }
+        else {
+            size_t n = 0;
+            for(; n < 3 && next + n < PER_PRODUCER; n++) {
+                batch[n].producer = id;
+                batch[n].seq = next + n;
+            }
+            int64_t pushed = mpmc_queue_try_push_n(shared, batch, n);
+            if(pushed == 0) {
+                sched_yield();
+            }
+            next += pushed;
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    struct consumer_result *result = arg;
+    uint64_t last[THREADS];
+    struct message batch[4];
+    memset(last, 0, sizeof(last));
+    result->ordered = 1;
+    while(result->count < PER_PRODUCER) {
+        // never take more than this consumer's share, so none are starved
+        uint64_t want = PER_PRODUCER - result->count;
+        int64_t n = mpmc_queue_try_pop_n(shared, batch, want < 4 ? want:4);
+        if(n == 0 && mpmc_queue_pop(shared, batch) == ALC_MPMC_QUEUE_SUCCESS) {
+            n = 1;
+        }
+        for(int64_t i = 0; i < n; i++) {
+            // each producer's messages are seen in order by any one consumer
+            if(batch[i].seq + 1 < last[batch[i].producer]) {
+                result->ordered = 0;
+            }
+            last[batch[i].producer] = batch[i].seq + 1;
+            result->sum += batch[i].seq;
+            result->count++;
+        }
+    }
+    return NULL;
+}
+
+static void test_threads(void **state) {
+    pthread_t producers[THREADS];
+    pthread_t consumers[THREADS];
+    struct consumer_result results[THREADS];
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    shared = create_mpmc_queue(64, sizeof(struct message));
+    assert_non_null(shared);
+    memset(results, 0, sizeof(results));
+    for(uintptr_t i = 0; i < THREADS; i++) {
+        pthread_create(&consumers[i], NULL, consumer, &results[i]);
+        pthread_create(&producers[i], NULL, producer, (void*)i);
+    }
+    for(int i = 0; i < THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+        assert_true(results[i].ordered);
+        count += results[i].count;
+        sum += results[i].sum;
+    }
+    assert_int_equal(count, (uint64_t)THREADS * PER_PRODUCER);
+    assert_int_equal(sum,
+            (uint64_t)THREADS * PER_PRODUCER * (PER_PRODUCER - 1) / 2);
+    assert_int_equal(mpmc_queue_size(shared), 0);
+    mpmc_queue_free(shared);
+}
+
+static void test_invalid_calls(void **state) {
+    int out;
+    assert_null(create_mpmc_queue(0, 4));
+    assert_null(create_mpmc_queue(4, 0));
+    assert_null(create_mpmc_queue(SIZE_MAX, 4));
+    assert_int_equal(mpmc_queue_try_push(NULL, NULL), ALC_MPMC_QUEUE_INVALID);
+    assert_int_equal(mpmc_queue_push(NULL, NULL), ALC_MPMC_QUEUE_INVALID);
+    assert_int_equal(mpmc_queue_try_pop(NULL, &out), ALC_MPMC_QUEUE_INVALID);
+    assert_int_equal(mpmc_queue_pop(*state, NULL), ALC_MPMC_QUEUE_INVALID);
+    assert_int_equal(mpmc_queue_try_push_n(NULL, &out, 1),
+            ALC_MPMC_QUEUE_INVALID);
+    assert_int_equal(mpmc_queue_try_pop_n(*state, NULL, 1),
+            ALC_MPMC_QUEUE_INVALID);
+    assert_int_equal(mpmc_queue_size(NULL), -1);
+    assert_int_equal(mpmc_queue_capacity(NULL), -1);
+    mpmc_queue_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_push_pop,
+            queue_init,
+            queue_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_batch,
+            queue_init,
+            queue_finish
+        ),
+        cmocka_unit_test(test_threads),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            queue_init,
+            queue_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <alibc/containers/pool.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+// odd-sized record to exercise object size rounding
+struct record {
+    uint64_t id;
+    char name[20];
+};
+
+static int pool_init(void **state) {
+    pool_t *uut = create_pool(sizeof(struct record), 4, ALC_POOL_DEFAULT);
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int pool_init_shared(void **state) {
+    pool_t *uut = create_pool(sizeof(struct record), 16, ALC_POOL_SHARED);
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int pool_finish(void **state) {
+    pool_free((pool_t*)*state);
+    return 0;
+}
+
+static void test_alloc(void **state) {
+    pool_t *uut = *state;
+    struct record *records[10];
+    // spans several chunks
+    for(int i = 0; i < 10; i++) {
+        records[i] = pool_alloc(uut);
+        assert_non_null(records[i]);
+        assert_int_equal((uintptr_t)records[i] % ALC_POOL_ALIGN, 0);
+        records[i]->id = i;
+        snprintf(records[i]->name, sizeof(records[i]->name), "record %d", i);
+    }
+    assert_int_equal(pool_size(uut), 10);
+    assert_int_equal(uut->nchunks, 3);
+
+    // addresses are stable across chunk allocation
+    for(int i = 0; i < 10; i++) {
+        char expect[20];
+        snprintf(expect, sizeof(expect), "record %d", i);
+        assert_int_equal(records[i]->id, i);
+        assert_true(strcmp(records[i]->name, expect) == 0);
+    }
+}
+
+static void test_release(void **state) {
+    pool_t *uut = *state;
+    void *first = pool_alloc(uut);
+    void *second = pool_alloc(uut);
+    assert_int_equal(pool_release(uut, first), ALC_POOL_SUCCESS);
+    assert_int_equal(pool_size(uut), 1);
+
+    // released objects are reused before carving new ones
+    void *third = pool_alloc(uut);
+    assert_ptr_equal(third, first);
+    assert_int_equal(pool_size(uut), 2);
+
+    pool_release(uut, second);
+    pool_release(uut, third);
+    assert_int_equal(pool_size(uut), 0);
+    assert_int_equal(pool_release(uut, NULL), ALC_POOL_INVALID_REQ);
+    assert_int_equal(pool_status(uut), ALC_POOL_INVALID_REQ);
+}
+
+static void test_aligned(void **state) {
+    pool_t *uut = create_pool(24, 3, ALC_POOL_ALIGNED);
+    assert_non_null(uut);
+    assert_int_equal(uut->obj_size, ALC_POOL_CACHELINE);
+    for(int i = 0; i < 7; i++) {
+        void *obj = pool_alloc(uut);
+        assert_non_null(obj);
+        assert_int_equal((uintptr_t)obj % ALC_POOL_CACHELINE, 0);
+    }
+    pool_free(uut);
+}
+
+static void *cache_worker(void *arg) {
+    pool_t *pool = arg;
+    pool_cache_t cache;
+    struct record *held[64];
+    pool_cache_init(&cache, pool, 8);
+    for(int round = 0; round < 100; round++) {
+        for(int i = 0; i < 64; i++) {
+            held[i] = pool_cache_alloc(&cache);
+            held[i]->id = i;
+        }
+        for(int i = 0; i < 64; i++) {
+            if(held[i]->id != i) {
+                return arg;
+            }
+            pool_cache_release(&cache, held[i]);
+        }
+    }
+    pool_cache_flush(&cache);
+    return NULL;
+}
+
+static void test_cache(void **state) {
+    pool_t *uut = *state;
+    pthread_t threads[4];
+    for(int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, cache_worker, uut);
+    }
+    for(int i = 0; i < 4; i++) {
+        void *r;
+        pthread_join(threads[i], &r);
+        assert_null(r);
+    }
+    assert_int_equal(pool_size(uut), 0);
+}
+
+static void test_invalid_calls(void **state) {
+    pool_cache_t cache;
+    assert_null(create_pool(0, 4, ALC_POOL_DEFAULT));
+    assert_null(create_pool(8, 0, ALC_POOL_DEFAULT));
+    assert_null(pool_alloc(NULL));
+    assert_int_equal(pool_release(NULL, NULL), ALC_POOL_INVALID);
+    assert_int_equal(pool_size(NULL), -1);
+    assert_int_equal(pool_status(NULL), ALC_POOL_INVALID);
+    assert_int_equal(pool_cache_init(&cache, NULL, 8), ALC_POOL_INVALID);
+
+    // caches are only allowed on shared pools
+    pool_t *uut = *state;
+    assert_int_equal(pool_cache_init(&cache, uut, 8), ALC_POOL_INVALID_REQ);
+    pool_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_alloc,
+            pool_init,
+            pool_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_release,
+            pool_init,
+            pool_finish
+        ),
+        cmocka_unit_test(test_aligned),
+        cmocka_unit_test_setup_teardown(
+            test_cache,
+            pool_init_shared,
+            pool_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            pool_init,
+            pool_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <alibc/containers/array.h>
+#include <alibc/containers/search_array.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+static int8_t cmp_int(void *a, void *b) {
+    int x = (int)(intptr_t)a;
+    int y = (int)(intptr_t)b;
+    return (x > y) - (x < y);
+}
+
+struct record {
+    int64_t key;
+    int64_t value;
+    char pad[16];
+};
+
+static int8_t cmp_record(void *a, void *b) {
+    int64_t x = ((struct record*)a)->key;
+    int64_t y = ((struct record*)b)->key;
+    return (x > y) - (x < y);
+}
+
+// even numbers 0..2*(count-1)
+static int sa_init(void **state) {
+    array_t *sorted = create_array(1, sizeof(int));
+    for(int i = 0; i < 1000; i++) {
+        array_append(sorted, (void*)(intptr_t)(2*i));
+    }
+    search_array_t *uut = create_search_array(sorted, cmp_int);
+    array_free(sorted);
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int sa_finish(void **state) {
+    search_array_free((search_array_t*)*state);
+    return 0;
+}
+
+static void test_find(void **state) {
+    search_array_t *uut = *state;
+    assert_int_equal(search_array_size(uut), 1000);
+    for(int i = 0; i < 2000; i++) {
+        void **r = search_array_find(uut, (void*)(intptr_t)i);
+        if(i % 2) {
+            assert_null(r);
+            assert_int_equal(search_array_status(uut),
+                    ALC_SEARCH_ARRAY_NOT_FOUND);
+        }
+        else {
+            assert_non_null(r);
+            assert_int_equal(*(int*)r, i);
+        }
+    }
+}
+
+static void test_lower_bound(void **state) {
+    search_array_t *uut = *state;
+    for(int i = -5; i < 1998; i++) {
+        void **r = search_array_lower_bound(uut, (void*)(intptr_t)i);
+        assert_non_null(r);
+        assert_int_equal(*(int*)r, (i < 0) ? 0:(i + 1) / 2 * 2);
+    }
+    assert_null(search_array_lower_bound(uut, (void*)(intptr_t)1999));
+}
+
+static void test_duplicates(void **state) {
+    int values[] = {1, 1, 1, 4, 4, 9};
+    array_t *sorted = create_array(1, sizeof(int));
+    for(int i = 0; i < 6; i++) {
+        array_append(sorted, (void*)(intptr_t)values[i]);
+    }
+    search_array_t *uut = create_search_array(sorted, cmp_int);
+    assert_non_null(uut);
+    assert_int_equal(*(int*)search_array_find(uut, (void*)4), 4);
+    assert_int_equal(*(int*)search_array_lower_bound(uut, (void*)2), 4);
+    assert_int_equal(*(int*)search_array_lower_bound(uut, (void*)0), 1);
+    assert_null(search_array_find(uut, (void*)5));
+    search_array_free(uut);
+    array_free(sorted);
+}
+
+static void test_big(void **state) {
+    array_t *sorted = create_array(1, sizeof(struct record));
+    for(int64_t i = 0; i < 333; i++) {
+        struct record item = {i*3, -i};
+        array_append(sorted, &item);
+    }
+    search_array_t *uut = create_search_array(sorted, cmp_record);
+    array_free(sorted);
+    assert_non_null(uut);
+    for(int64_t i = 0; i < 333; i++) {
+        struct record key = {i*3, 0};
+        struct record *r = (struct record*)search_array_find(uut, &key);
+        assert_non_null(r);
+        assert_int_equal(r->value, -i);
+        key.key++;
+        assert_null(search_array_find(uut, &key));
+    }
+    search_array_free(uut);
+}
+
+static void test_invalid_calls(void **state) {
+    array_t *empty = create_array(1, sizeof(int));
+    search_array_t *uut = create_search_array(empty, cmp_int);
+    assert_non_null(uut);
+    assert_int_equal(search_array_size(uut), 0);
+    assert_null(search_array_find(uut, (void*)1));
+    assert_null(search_array_lower_bound(uut, (void*)1));
+    search_array_free(uut);
+
+    assert_null(create_search_array(NULL, cmp_int));
+    assert_null(create_search_array(empty, NULL));
+    assert_null(search_array_find(NULL, NULL));
+    assert_null(search_array_lower_bound(NULL, NULL));
+    assert_int_equal(search_array_size(NULL), -1);
+    assert_int_equal(search_array_status(NULL), ALC_SEARCH_ARRAY_INVALID);
+    search_array_free(NULL);
+    array_free(empty);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_find,
+            sa_init,
+            sa_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_lower_bound,
+            sa_init,
+            sa_finish
+        ),
+        cmocka_unit_test(test_duplicates),
+        cmocka_unit_test(test_big),
+        cmocka_unit_test(test_invalid_calls)
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -18,7 +18,7 @@ char *items[] = {"do not go gentle into that good night,",
                  "do not go gentle into that good night."
 };
 
-static bool full_load(int entries, int capacity) {
+static bool full_load(size_t entries, size_t capacity) {
     return entries >= capacity;
 }
 
@@ -98,6 +98,24 @@ static void test_resize(void **state) {
     assert_int_equal(result, ALC_SET_SUCCESS);
 }
 
+static uint32_t hash_seven(void *item) {
+    return 7;
+}
+
+static void test_rehash(void **state) {
+    // collisions are probed through the whole of the new table
+    set_t *uut = create_set(8, sizeof(int64_t), hash_seven,
+            alc_default_cmp_i64, full_load);
+    set_add(uut, (void*)1);
+    set_add(uut, (void*)2);
+    assert_int_equal(set_resize(uut, 16), ALC_SET_SUCCESS);
+    assert_true(bitmap_contains(uut->_filter, 7));
+    assert_true(bitmap_contains(uut->_filter, 8));
+    assert_false(bitmap_contains(uut->_filter, 0));
+    assert_true(set_contains(uut, (void*)2));
+    set_free(uut);
+}
+
 static void test_iterator(void **state) {
     // test with a bad context
     iter_context *iter = create_set_iterator(NULL);
@@ -131,6 +149,107 @@ static void test_iterator(void **state) {
     iter_free(iter);
 }
 
+static void test_iterator_static(void **state) {
+    set_t *uut = *state;
+    iter_context iter;
+    int count = 0;
+    assert_int_equal(iter_init_set(NULL, uut), ALC_ITER_NULL);
+    assert_int_equal(iter_init_set(&iter, NULL), ALC_ITER_INVALID);
+
+    for(int i = 0; i < 6; i++)  {
+        set_add(uut, items[i]);
+    }
+    assert_int_equal(iter_init_set(&iter, uut), ALC_ITER_READY);
+    assert_int_equal(iter.flags, ALC_ITER_STATIC);
+    for(void **next = iter_next(&iter); next != NULL; next = iter_next(&iter)) {
+        assert_true(set_contains(uut, *next));
+        count++;
+    }
+    assert_int_equal(count, 6);
+    assert_int_equal(iter_status(&iter), ALC_ITER_STOP);
+    iter_free(&iter);
+}
+
+static void test_iterator_batch(void **state) {
+    set_t *uut = *state;
+    iter_context iter;
+    void **batch[4];
+    int count = 0;
+    int n;
+    for(int i = 0; i < 6; i++)  {
+        set_add(uut, items[i]);
+    }
+    iter_init_set(&iter, uut);
+    while((n = iter_next_batch(&iter, (void**)batch, 4)) > 0) {
+        assert_true(n <= 4);
+        for(int i = 0; i < n; i++) {
+            assert_true(set_contains(uut, *batch[i]));
+        }
+        count += n;
+    }
+    assert_int_equal(n, 0);
+    assert_int_equal(count, 6);
+    assert_int_equal(iter_status(&iter), ALC_ITER_STOP);
+}
+
+static void test_foreach(void **state) {
+    set_t *uut = *state;
+    void **item;
+    int count = 0;
+    ALC_SET_FOREACH(uut, item) {
+        count++;
+    }
+    assert_int_equal(count, 0);
+    for(int i = 0; i < 6; i++)  {
+        set_add(uut, items[i]);
+    }
+    ALC_SET_FOREACH(uut, item) {
+        assert_true(set_contains(uut, *item));
+        count++;
+    }
+    assert_int_equal(count, 6);
+}
+
+static void test_iterator_range(void **state) {
+    set_t *uut = *state;
+    iter_context parts[3];
+    iter_context *iter;
+    int count = 0;
+    for(int i = 0; i < 6; i++)  {
+        set_add(uut, items[i]);
+    }
+    // ranges over the two halves of the table see every member once
+    size_t half = uut->capacity / 2;
+    iter_context *halves[] = {
+        create_set_iterator_range(uut, 0, half),
+        create_set_iterator_range(uut, half, ALC_ITER_END)
+    };
+    for(int i = 0; i < 2; i++) {
+        assert_non_null(halves[i]);
+        for(void **next = iter_next(halves[i]); next != NULL;
+                next = iter_next(halves[i])) {
+            assert_true(set_contains(uut, *next));
+            count++;
+        }
+        iter_free(halves[i]);
+    }
+    assert_int_equal(count, 6);
+    assert_null(create_set_iterator_range(uut, 2, 1));
+
+    count = 0;
+    iter = create_set_iterator(uut);
+    assert_int_equal(iter_split(iter, parts, 3), 3);
+    assert_int_equal(parts[2].end, uut->capacity);
+    for(int i = 0; i < 3; i++) {
+        void *batch[6];
+        int n = iter_next_batch(&parts[i], batch, 6);
+        assert_true(n >= 0);
+        count += n;
+    }
+    assert_int_equal(count, 6);
+    iter_free(iter);
+}
+
 static void test_invalid_calls(void **state) {
     // test every check_space_available/check_valid case
     int r = set_add(NULL, NULL);
@@ -206,11 +325,32 @@ int main(int argc, char **argv) {
             set_init,
             set_finish
         ),
+        cmocka_unit_test(test_rehash),
         cmocka_unit_test_setup_teardown(
             test_iterator,
             set_init,
             set_finish
         ),
+        cmocka_unit_test_setup_teardown(
+            test_iterator_static,
+            set_init,
+            set_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iterator_batch,
+            set_init,
+            set_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_foreach,
+            set_init,
+            set_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_iterator_range,
+            set_init,
+            set_finish
+        ),
         cmocka_unit_test_setup_teardown(
             test_invalid_calls,
             set_init,
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <alibc/containers/small_array.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+struct wide {
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+};
+
+static int small_array_init(void **state) {
+    small_array_t *uut = create_small_array(4, sizeof(int));
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int small_array_finish(void **state) {
+    small_array_free((small_array_t*)*state);
+    return 0;
+}
+
+static void test_inline(void **state) {
+    small_array_t *uut = *state;
+    for(int i = 0; i < 4; i++) {
+        assert_int_equal(small_array_append(uut, (void*)(intptr_t)i),
+                ALC_SMALL_ARRAY_SUCCESS);
+    }
+    // all four elements live in the header allocation
+    assert_true(small_array_is_inline(uut));
+    assert_ptr_equal(small_array_data(uut), (void*)uut->_inline);
+    for(int i = 0; i < 4; i++) {
+        assert_int_equal(*(int*)small_array_fetch(uut, i), i);
+    }
+    assert_int_equal(small_array_size(uut), 4);
+}
+
+static void test_spill(void **state) {
+    small_array_t *uut = *state;
+    for(int i = 0; i < 100; i++) {
+        assert_int_equal(small_array_append(uut, (void*)(intptr_t)i),
+                ALC_SMALL_ARRAY_SUCCESS);
+    }
+    assert_false(small_array_is_inline(uut));
+    assert_int_equal(uut->data.mode, ALC_DYNABUF_HEAP);
+    for(int i = 0; i < 100; i++) {
+        assert_int_equal(*(int*)small_array_at_unchecked(uut, i), i);
+    }
+    assert_int_equal(small_array_size(uut), 100);
+}
+
+static void test_insert_remove(void **state) {
+    small_array_t *uut = *state;
+    small_array_append(uut, (void*)10);
+    small_array_append(uut, (void*)20);
+    // the displaced item moves to the end
+    assert_int_equal(small_array_insert(uut, 0, (void*)30),
+            ALC_SMALL_ARRAY_SUCCESS);
+    assert_int_equal(*(int*)small_array_fetch(uut, 0), 30);
+    assert_int_equal(*(int*)small_array_fetch(uut, 1), 20);
+    assert_int_equal(*(int*)small_array_fetch(uut, 2), 10);
+
+    // the last item takes the place of the removed one
+    assert_int_equal(*(int*)small_array_remove(uut, 0), 30);
+    assert_int_equal(small_array_size(uut), 2);
+    assert_int_equal(*(int*)small_array_fetch(uut, 0), 10);
+    assert_int_equal(*(int*)small_array_fetch(uut, 1), 20);
+
+    assert_int_equal(small_array_insert(uut, 3, (void*)1),
+            ALC_SMALL_ARRAY_IDX_OOB);
+    assert_null(small_array_remove(uut, 2));
+    assert_int_equal(small_array_status(uut), ALC_SMALL_ARRAY_IDX_OOB);
+}
+
+static void test_wide(void **state) {
+    small_array_t *uut = create_small_array(2, sizeof(struct wide));
+    assert_non_null(uut);
+    assert_int_equal((uintptr_t)small_array_data(uut) % sizeof(uint64_t), 0);
+    for(uint64_t i = 0; i < 5; i++) {
+        struct wide item = {i, i*2, i*3};
+        assert_int_equal(small_array_append(uut, &item),
+                ALC_SMALL_ARRAY_SUCCESS);
+    }
+    assert_false(small_array_is_inline(uut));
+    struct wide *removed = (struct wide*)small_array_remove(uut, 1);
+    assert_int_equal(removed->b, 2);
+    struct wide *moved = (struct wide*)small_array_fetch(uut, 1);
+    assert_int_equal(moved->a, 4);
+    assert_int_equal(moved->c, 12);
+    small_array_free(uut);
+}
+
+static void test_resize(void **state) {
+    small_array_t *uut = *state;
+    // shrinking or staying inline does not allocate
+    assert_int_equal(small_array_resize(uut, 2), ALC_SMALL_ARRAY_SUCCESS);
+    assert_true(small_array_is_inline(uut));
+    small_array_append(uut, (void*)7);
+    assert_int_equal(small_array_resize(uut, 64), ALC_SMALL_ARRAY_SUCCESS);
+    assert_false(small_array_is_inline(uut));
+    assert_int_equal(*(int*)small_array_fetch(uut, 0), 7);
+    assert_true(uut->data.capacity >= 64*sizeof(int));
+}
+
+static void test_invalid_calls(void **state) {
+    assert_null(create_small_array(4, 0));
+    assert_null(create_small_array(SIZE_MAX, 8));
+    assert_int_equal(small_array_append(NULL, NULL), ALC_SMALL_ARRAY_INVALID);
+    assert_int_equal(small_array_insert(NULL, 0, NULL),
+            ALC_SMALL_ARRAY_INVALID);
+    assert_null(small_array_fetch(NULL, 0));
+    assert_null(small_array_remove(NULL, 0));
+    assert_int_equal(small_array_resize(NULL, 1), ALC_SMALL_ARRAY_INVALID);
+    assert_int_equal(small_array_size(NULL), -1);
+    assert_int_equal(small_array_status(NULL), ALC_SMALL_ARRAY_INVALID);
+    assert_false(small_array_is_inline(NULL));
+    small_array_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_inline,
+            small_array_init,
+            small_array_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_spill,
+            small_array_init,
+            small_array_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_insert_remove,
+            small_array_init,
+            small_array_finish
+        ),
+        cmocka_unit_test(test_wide),
+        cmocka_unit_test_setup_teardown(
+            test_resize,
+            small_array_init,
+            small_array_finish
+        ),
+        cmocka_unit_test(test_invalid_calls)
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
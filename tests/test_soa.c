@@ -0,0 +1,164 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <alibc/containers/soa.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+enum {FIELD_ID, FIELD_SCORE, FIELD_NAME, FIELD_COUNT};
+
+// a field larger than a pointer, passed by address
+struct name {
+    char text[24];
+};
+
+static const size_t fields[] = {
+    sizeof(uint64_t), sizeof(float), sizeof(struct name)
+};
+
+static int soa_init(void **state) {
+    soa_t *uut = create_soa(2, fields, FIELD_COUNT);
+    assert_non_null(uut);
+    for(uint64_t i = 0; i < 100; i++) {
+        struct name n;
+        float score = i * 0.5f;
+        void *row[FIELD_COUNT];
+        uint32_t bits;
+        snprintf(n.text, sizeof(n.text), "row %d", (int)i);
+        memcpy(&bits, &score, sizeof(bits));
+        row[FIELD_ID] = (void*)i;
+        row[FIELD_SCORE] = (void*)(uintptr_t)bits;
+        row[FIELD_NAME] = &n;
+        assert_int_equal(soa_append(uut, row), ALC_SOA_SUCCESS);
+    }
+    *state = uut;
+    return 0;
+}
+
+static int soa_finish(void **state) {
+    soa_free((soa_t*)*state);
+    return 0;
+}
+
+static void test_fetch(void **state) {
+    soa_t *uut = *state;
+    void **row[FIELD_COUNT];
+    assert_int_equal(soa_size(uut), 100);
+    assert_true(uut->capacity >= 100);
+    for(int i = 0; i < 100; i++) {
+        char expect[24];
+        snprintf(expect, sizeof(expect), "row %d", i);
+        assert_int_equal(*(uint64_t*)soa_fetch(uut, i, FIELD_ID), i);
+        assert_true(*(float*)soa_fetch(uut, i, FIELD_SCORE) == i * 0.5f);
+        assert_string_equal(((struct name*)soa_fetch(uut, i, FIELD_NAME))->text,
+                expect);
+        assert_int_equal(soa_fetch_row(uut, i, row), ALC_SOA_SUCCESS);
+        assert_ptr_equal(row[FIELD_NAME], soa_at_unchecked(uut, i, FIELD_NAME));
+    }
+    assert_null(soa_fetch(uut, 100, FIELD_ID));
+    assert_int_equal(soa_status(uut), ALC_SOA_IDX_OOB);
+    assert_null(soa_fetch(uut, 0, FIELD_COUNT));
+}
+
+static void test_column(void **state) {
+    soa_t *uut = *state;
+    // columns are packed arrays of a single field
+    float *scores = soa_column(uut, FIELD_SCORE);
+    uint64_t *ids = soa_column(uut, FIELD_ID);
+    assert_int_equal((uintptr_t)scores % ALC_DYNABUF_ALIGN_CACHELINE, 0);
+    assert_int_equal((uintptr_t)ids % ALC_DYNABUF_ALIGN_CACHELINE, 0);
+    float total = 0;
+    uint64_t id_total = 0;
+    for(int i = 0; i < soa_size(uut); i++) {
+        total += scores[i];
+        id_total += ids[i];
+    }
+    assert_true(total == 99 * 100 / 4.0f);
+    assert_int_equal(id_total, 99 * 100 / 2);
+    assert_null(soa_column(uut, FIELD_COUNT));
+}
+
+static void test_set_remove(void **state) {
+    soa_t *uut = *state;
+    struct name n = {"renamed"};
+    assert_int_equal(soa_set(uut, 5, FIELD_NAME, &n), ALC_SOA_SUCCESS);
+    assert_int_equal(soa_set(uut, 5, FIELD_ID, (void*)500), ALC_SOA_SUCCESS);
+    assert_int_equal(soa_set(uut, 100, FIELD_ID, NULL), ALC_SOA_IDX_OOB);
+    assert_string_equal(((struct name*)soa_fetch(uut, 5, FIELD_NAME))->text,
+            "renamed");
+
+    // the last row moves into the gap, with every field
+    assert_int_equal(soa_remove(uut, 5), ALC_SOA_SUCCESS);
+    assert_int_equal(soa_size(uut), 99);
+    assert_int_equal(*(uint64_t*)soa_fetch(uut, 5, FIELD_ID), 99);
+    assert_true(*(float*)soa_fetch(uut, 5, FIELD_SCORE) == 49.5f);
+    assert_string_equal(((struct name*)soa_fetch(uut, 5, FIELD_NAME))->text,
+            "row 99");
+    assert_int_equal(soa_remove(uut, 98), ALC_SOA_SUCCESS);
+    assert_int_equal(soa_size(uut), 98);
+    assert_int_equal(soa_remove(uut, 98), ALC_SOA_IDX_OOB);
+}
+
+static void test_resize(void **state) {
+    soa_t *uut = *state;
+    assert_int_equal(soa_resize(uut, 1000), ALC_SOA_SUCCESS);
+    assert_int_equal(uut->capacity, 1000);
+    for(int i = 0; i < FIELD_COUNT; i++) {
+        assert_true(uut->columns[i]->capacity >= 1000 * fields[i]);
+    }
+    // shrinking is a no-op
+    assert_int_equal(soa_resize(uut, 10), ALC_SOA_SUCCESS);
+    assert_int_equal(uut->capacity, 1000);
+    assert_int_equal(*(uint64_t*)soa_fetch(uut, 99, FIELD_ID), 99);
+}
+
+static void test_invalid_calls(void **state) {
+    size_t bad[] = {4, 0};
+    void **row[FIELD_COUNT];
+    assert_null(create_soa(4, NULL, 2));
+    assert_null(create_soa(4, fields, 0));
+    assert_null(create_soa(4, bad, 2));
+    assert_int_equal(soa_append(NULL, NULL), ALC_SOA_INVALID);
+    assert_int_equal(soa_append(*state, NULL), ALC_SOA_INVALID);
+    assert_int_equal(soa_set(NULL, 0, 0, NULL), ALC_SOA_INVALID);
+    assert_null(soa_fetch(NULL, 0, 0));
+    assert_int_equal(soa_fetch_row(NULL, 0, row), ALC_SOA_INVALID);
+    assert_int_equal(soa_fetch_row(*state, 0, NULL), ALC_SOA_INVALID);
+    assert_int_equal(soa_remove(NULL, 0), ALC_SOA_INVALID);
+    assert_null(soa_column(NULL, 0));
+    assert_int_equal(soa_resize(NULL, 4), ALC_SOA_INVALID);
+    assert_int_equal(soa_size(NULL), -1);
+    assert_int_equal(soa_status(NULL), ALC_SOA_INVALID);
+    soa_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_fetch,
+            soa_init,
+            soa_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_column,
+            soa_init,
+            soa_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_set_remove,
+            soa_init,
+            soa_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_resize,
+            soa_init,
+            soa_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            soa_init,
+            soa_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <alibc/containers/spsc_ring.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define TRANSFER_COUNT 200000
+
+// larger than a pointer, so it is passed to push by address
+struct record {
+    uint64_t id;
+    uint64_t check;
+    char pad[8];
+};
+
+static int ring_init(void **state) {
+    spsc_ring_t *uut = create_spsc_ring(6, sizeof(int));
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int ring_finish(void **state) {
+    spsc_ring_free((spsc_ring_t*)*state);
+    return 0;
+}
+
+static void test_push_pop(void **state) {
+    spsc_ring_t *uut = *state;
+    int out;
+    // capacity is rounded up to a power of two
+    assert_int_equal(spsc_ring_capacity(uut), 8);
+    assert_int_equal(spsc_ring_pop(uut, &out), ALC_SPSC_RING_EMPTY);
+
+    // wrap around the end of the buffer a few times
+    for(int round = 0; round < 5; round++) {
+        for(int i = 0; i < 8; i++) {
+            assert_int_equal(spsc_ring_push(uut, (void*)(intptr_t)(round*8 + i)),
+                    ALC_SPSC_RING_SUCCESS);
+        }
+        assert_int_equal(spsc_ring_push(uut, (void*)-1), ALC_SPSC_RING_FULL);
+        assert_int_equal(spsc_ring_size(uut), 8);
+        for(int i = 0; i < 5; i++) {
+            assert_int_equal(spsc_ring_pop(uut, &out), ALC_SPSC_RING_SUCCESS);
+            assert_int_equal(out, round*8 + i);
+        }
+        for(int i = 5; i < 8; i++) {
+            assert_int_equal(spsc_ring_pop(uut, &out), ALC_SPSC_RING_SUCCESS);
+            assert_int_equal(out, round*8 + i);
+        }
+        assert_int_equal(spsc_ring_size(uut), 0);
+    }
+}
+
+static void test_batch(void **state) {
+    spsc_ring_t *uut = *state;
+    int in[12];
+    int out[12];
+    for(int i = 0; i < 12; i++) {
+        in[i] = i * 3;
+    }
+    // move the indices off zero so batches wrap
+    assert_int_equal(spsc_ring_push_n(uut, in, 5), 5);
+    assert_int_equal(spsc_ring_pop_n(uut, out, 5), 5);
+
+    // only as many as fit are pushed
+    assert_int_equal(spsc_ring_push_n(uut, in, 12), 8);
+    assert_int_equal(spsc_ring_push_n(uut, in, 1), 0);
+    memset(out, 0, sizeof(out));
+    assert_int_equal(spsc_ring_pop_n(uut, out, 3), 3);
+    assert_int_equal(spsc_ring_pop_n(uut, out + 3, 12), 5);
+    for(int i = 0; i < 8; i++) {
+        assert_int_equal(out[i], i * 3);
+    }
+    assert_int_equal(spsc_ring_pop_n(uut, out, 12), 0);
+}
+
+static void *producer(void *arg) {
+    spsc_ring_t *ring = arg;
+    struct record batch[7];
+    uint64_t next = 0;
+    while(next < TRANSFER_COUNT) {
+        // alternate single and batch pushes
+        if(next % 2) {
+            struct record rec = {next, next * 31};
+            if(spsc_ring_push(ring, &rec) == ALC_SPSC_RING_SUCCESS) {
+                next++;
+            }
+            else {
+                sched_yield();
+            }
+        }
+        else {
+            size_t n = 0;
+            for(; n < 7 && next + n < TRANSFER_COUNT; n++) {
+                batch[n].id = next + n;
+                batch[n].check = (next + n) * 31;
+            }
+            int64_t pushed = spsc_ring_push_n(ring, batch, n);
+            if(pushed == 0) {
+                sched_yield();
+            }
+            next += pushed;
+        }
+    }
+    return NULL;
+}
+
+static void test_threads(void **state) {
+    spsc_ring_t *uut = create_spsc_ring(64, sizeof(struct record));
+    assert_non_null(uut);
+    pthread_t thread;
+    pthread_create(&thread, NULL, producer, uut);
+
+    struct record batch[5];
+    uint64_t expect = 0;
+    int ordered = 1;
+    while(expect < TRANSFER_COUNT) {
+        int64_t n = spsc_ring_pop_n(uut, batch, 5);
+        if(n == 0) {
+            sched_yield();
+        }
+        for(int64_t i = 0; i < n; i++) {
+            if(batch[i].id != expect || batch[i].check != expect * 31) {
+                ordered = 0;
+            }
+            expect++;
+        }
+    }
+    pthread_join(thread, NULL);
+    assert_true(ordered);
+    assert_int_equal(spsc_ring_size(uut), 0);
+    spsc_ring_free(uut);
+}
+
+static void test_invalid_calls(void **state) {
+    int out;
+    assert_null(create_spsc_ring(0, 4));
+    assert_null(create_spsc_ring(4, 0));
+    assert_null(create_spsc_ring(SIZE_MAX, 4));
+    assert_int_equal(spsc_ring_push(NULL, NULL), ALC_SPSC_RING_INVALID);
+    assert_int_equal(spsc_ring_pop(NULL, &out), ALC_SPSC_RING_INVALID);
+    assert_int_equal(spsc_ring_pop(*state, NULL), ALC_SPSC_RING_INVALID);
+    assert_int_equal(spsc_ring_push_n(NULL, &out, 1), ALC_SPSC_RING_INVALID);
+    assert_int_equal(spsc_ring_pop_n(*state, NULL, 1), ALC_SPSC_RING_INVALID);
+    assert_int_equal(spsc_ring_size(NULL), -1);
+    assert_int_equal(spsc_ring_capacity(NULL), -1);
+    spsc_ring_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_push_pop,
+            ring_init,
+            ring_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_batch,
+            ring_init,
+            ring_finish
+        ),
+        cmocka_unit_test(test_threads),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            ring_init,
+            ring_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
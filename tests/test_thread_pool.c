@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <alibc/containers/thread_pool.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+static int pool_init(void **state) {
+    thread_pool_t *uut = create_thread_pool(4);
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int pool_finish(void **state) {
+    thread_pool_free((thread_pool_t*)*state);
+    return 0;
+}
+
+static void mark(void *arg, size_t task) {
+    int *hits = arg;
+    __atomic_fetch_add(&hits[task], 1, __ATOMIC_RELAXED);
+}
+
+static void test_run(void **state) {
+    thread_pool_t *uut = *state;
+    int hits[1000];
+    assert_int_equal(thread_pool_size(uut), 4);
+    // batches run back to back reuse the same workers
+    for(int round = 0; round < 50; round++) {
+        memset(hits, 0, sizeof(hits));
+        assert_int_equal(thread_pool_run(uut, mark, hits, 1000),
+                ALC_THREAD_POOL_SUCCESS);
+        for(int i = 0; i < 1000; i++) {
+            assert_int_equal(hits[i], 1);
+        }
+    }
+    assert_int_equal(thread_pool_run(uut, mark, hits, 0),
+            ALC_THREAD_POOL_SUCCESS);
+}
+
+static void test_single(void **state) {
+    int hits[10] = {0};
+    // a single thread pool runs everything on the caller
+    thread_pool_t *uut = create_thread_pool(1);
+    assert_non_null(uut);
+    assert_int_equal(thread_pool_run(uut, mark, hits, 10),
+            ALC_THREAD_POOL_SUCCESS);
+    for(int i = 0; i < 10; i++) {
+        assert_int_equal(hits[i], 1);
+    }
+    thread_pool_free(uut);
+
+    uut = create_thread_pool(0);
+    assert_non_null(uut);
+    assert_true(thread_pool_size(uut) >= 1);
+    thread_pool_free(uut);
+}
+
+static void test_invalid_calls(void **state) {
+    thread_pool_t *uut = *state;
+    assert_null(create_thread_pool(-1));
+    assert_int_equal(thread_pool_run(NULL, mark, NULL, 1),
+            ALC_THREAD_POOL_INVALID);
+    assert_int_equal(thread_pool_run(uut, NULL, NULL, 1),
+            ALC_THREAD_POOL_INVALID);
+    assert_int_equal(thread_pool_status(uut), ALC_THREAD_POOL_INVALID);
+    assert_int_equal(thread_pool_size(NULL), -1);
+    assert_int_equal(thread_pool_status(NULL), ALC_THREAD_POOL_INVALID);
+    thread_pool_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_run,
+            pool_init,
+            pool_finish
+        ),
+        cmocka_unit_test(test_single),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            pool_init,
+            pool_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <alibc/containers/ws_deque.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define THIEVES     3
+#define ITEM_COUNT  100000
+
+static int deque_init(void **state) {
+    ws_deque_t *uut = create_ws_deque(4);
+    assert_non_null(uut);
+    *state = uut;
+    return 0;
+}
+
+static int deque_finish(void **state) {
+    ws_deque_free((ws_deque_t*)*state);
+    return 0;
+}
+
+static void test_push_pop(void **state) {
+    ws_deque_t *uut = *state;
+    void *out;
+    assert_int_equal(ws_deque_pop(uut, &out), ALC_WS_DEQUE_EMPTY);
+    // grows past the initial size
+    for(uintptr_t i = 1; i <= 20; i++) {
+        assert_int_equal(ws_deque_push(uut, (void*)i), ALC_WS_DEQUE_SUCCESS);
+    }
+    assert_int_equal(ws_deque_size(uut), 20);
+    assert_int_equal(uut->nretired, 3);
+
+    // the owner pops newest first
+    for(uintptr_t i = 20; i > 0; i--) {
+        assert_int_equal(ws_deque_pop(uut, &out), ALC_WS_DEQUE_SUCCESS);
+        assert_ptr_equal(out, (void*)i);
+    }
+    assert_int_equal(ws_deque_pop(uut, &out), ALC_WS_DEQUE_EMPTY);
+    assert_int_equal(ws_deque_size(uut), 0);
+}
+
+static void test_steal(void **state) {
+    ws_deque_t *uut = *state;
+    void *out;
+    assert_int_equal(ws_deque_steal(uut, &out), ALC_WS_DEQUE_EMPTY);
+    for(uintptr_t i = 1; i <= 10; i++) {
+        ws_deque_push(uut, (void*)i);
+    }
+    // thieves take oldest first, while the owner works from the other end
+    assert_int_equal(ws_deque_steal(uut, &out), ALC_WS_DEQUE_SUCCESS);
+    assert_ptr_equal(out, (void*)1);
+    assert_int_equal(ws_deque_pop(uut, &out), ALC_WS_DEQUE_SUCCESS);
+    assert_ptr_equal(out, (void*)10);
+    for(uintptr_t i = 2; i <= 9; i++) {
+        assert_int_equal(ws_deque_steal(uut, &out), ALC_WS_DEQUE_SUCCESS);
+        assert_ptr_equal(out, (void*)i);
+    }
+    assert_int_equal(ws_deque_steal(uut, &out), ALC_WS_DEQUE_EMPTY);
+    assert_int_equal(ws_deque_pop(uut, &out), ALC_WS_DEQUE_EMPTY);
+}
+
+static ws_deque_t *shared;
+static atomic_int seen[ITEM_COUNT];
+static atomic_int done_pushing;
+
+static void *thief(void *arg) {
+    void *out;
+    for(;;) {
+        int status = ws_deque_steal(shared, &out);
+        if(status == ALC_WS_DEQUE_SUCCESS) {
+            atomic_fetch_add(&seen[(uintptr_t)out - 1], 1);
+        }
+        else if(status == ALC_WS_DEQUE_EMPTY) {
+            if(atomic_load(&done_pushing)) {
+                break;
+            }
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_threads(void **state) {
+    pthread_t thieves[THIEVES];
+    void *out;
+    shared = create_ws_deque(16);
+    assert_non_null(shared);
+    atomic_store(&done_pushing, 0);
+    for(int i = 0; i < ITEM_COUNT; i++) {
+        atomic_store(&seen[i], 0);
+    }
+    for(int i = 0; i < THIEVES; i++) {
+        pthread_create(&thieves[i], NULL, thief, NULL);
+    }
+
+    // the owner pops one item for every three it pushes
+    for(uintptr_t i = 1; i <= ITEM_COUNT; i++) {
+        assert_int_equal(ws_deque_push(shared, (void*)i), ALC_WS_DEQUE_SUCCESS);
+        if(i % 3 == 0 && ws_deque_pop(shared, &out) == ALC_WS_DEQUE_SUCCESS) {
+            atomic_fetch_add(&seen[(uintptr_t)out - 1], 1);
+        }
+    }
+    while(ws_deque_pop(shared, &out) == ALC_WS_DEQUE_SUCCESS) {
+        atomic_fetch_add(&seen[(uintptr_t)out - 1], 1);
+    }
+    atomic_store(&done_pushing, 1);
+    for(int i = 0; i < THIEVES; i++) {
+        pthread_join(thieves[i], NULL);
+    }
+
+    // every item was taken exactly once
+    for(int i = 0; i < ITEM_COUNT; i++) {
+        assert_int_equal(atomic_load(&seen[i]), 1);
+    }
+    assert_int_equal(ws_deque_size(shared), 0);
+    ws_deque_free(shared);
+}
+
+static void test_invalid_calls(void **state) {
+    void *out;
+    assert_null(create_ws_deque(0));
+    assert_null(create_ws_deque(SIZE_MAX));
+    assert_int_equal(ws_deque_push(NULL, NULL), ALC_WS_DEQUE_INVALID);
+    assert_int_equal(ws_deque_pop(NULL, &out), ALC_WS_DEQUE_INVALID);
+    assert_int_equal(ws_deque_pop(*state, NULL), ALC_WS_DEQUE_INVALID);
+    assert_int_equal(ws_deque_steal(NULL, &out), ALC_WS_DEQUE_INVALID);
+    assert_int_equal(ws_deque_steal(*state, NULL), ALC_WS_DEQUE_INVALID);
+    assert_int_equal(ws_deque_size(NULL), -1);
+    ws_deque_free(NULL);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(
+            test_push_pop,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test_setup_teardown(
+            test_steal,
+            deque_init,
+            deque_finish
+        ),
+        cmocka_unit_test(test_threads),
+        cmocka_unit_test_setup_teardown(
+            test_invalid_calls,
+            deque_init,
+            deque_finish
+        )
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}